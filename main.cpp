@@ -8,390 +8,5020 @@
 #include <fstream> // for CSV file writing
 #include <algorithm>
 #include <filesystem>
+#include <cstdint>
+#include <string_view>
+#include <cstring>
+#include <thread>
+#include <iterator>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <random>
+#include <cmath>
+#include <charconv>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <cerrno>
+#include <csignal>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#endif
 
 using namespace std;
 
-struct Player
-{
-    string name;
-    int score;
-};
+// -------------------- Player name arena --------------------
 
-struct ComparisonResult
+// Handle to a player name stored in the name arena.
+struct NameRef
 {
-    string algorithm;
-    double timeTaken;
-    string complexity;
+    uint32_t offset; // (block << NAME_BLOCK_BITS) | position in block
+    uint32_t length;
 };
 
-// -------------------- File handling: CSV helpers --------------------
+const int NAME_BLOCK_BITS = 20; // 1 MB blocks
+const uint32_t NAME_BLOCK_SIZE = 1u << NAME_BLOCK_BITS;
+const size_t NAME_MAX_BLOCKS = size_t(1) << (32 - NAME_BLOCK_BITS);
 
-// Append leaderboard rows to leaderboard.csv (creates file if missing).
-void saveToCSV(const vector<Player> &lb, const string &algoName)
+// Longest accepted player name; leaves room in a block for a " (k)" uniqueness suffix.
+const size_t MAX_NAME_BYTES = NAME_BLOCK_SIZE - 32;
+
+// Append-only string pool of fixed-size blocks. Blocks never move, so a NameRef and
+// any string_view taken from it stay valid for the life of the arena. Single writer.
+struct NameArena
 {
-    bool fileExists = filesystem::exists("leaderboard.csv");
+    vector<unique_ptr<char[]>> blocks;
+    uint32_t used = NAME_BLOCK_SIZE; // bytes used in the last block (full = none yet)
 
-    ofstream file("leaderboard.csv", ios::app); // append mode
-    if (!file)
+    NameArena()
     {
-        cout << "Error: Could not open leaderboard.csv\n";
-        return;
+        blocks.reserve(NAME_MAX_BLOCKS); // never reallocates, so readers may index it safely
     }
+};
 
-    // Write header only once
-    if (!fileExists)
-        file << "Rank,Name,Score,Algorithm\n";
-
-    int startRank = 1;
-    ifstream countFile("leaderboard.csv");
-    string line;
-    while (getline(countFile, line))
-        startRank++;
-    countFile.close();
+// Arena holding the names of every Player in the process.
+NameArena playerNames;
 
-    for (int i = 0; i < lb.size(); i++)
+// Copy name into the arena and return its handle. Callers reject names longer than
+// MAX_NAME_BYTES; anything that cannot fit in one block throws.
+NameRef internName(NameArena &arena, string_view name)
+{
+    if (name.size() > NAME_BLOCK_SIZE)
+        throw length_error("player name longer than 1 MB");
+    uint32_t length = uint32_t(name.size());
+    if (arena.used + length > NAME_BLOCK_SIZE || arena.blocks.empty())
     {
-        file << startRank + i << "," << lb[i].name << "," << lb[i].score << "," << algoName << "\n";
+        if (arena.blocks.size() == NAME_MAX_BLOCKS)
+            throw length_error("player name arena is full");
+        arena.blocks.push_back(make_unique<char[]>(NAME_BLOCK_SIZE));
+        arena.used = 0;
     }
+    NameRef ref = {uint32_t((arena.blocks.size() - 1) << NAME_BLOCK_BITS) | arena.used, length};
+    memcpy(arena.blocks.back().get() + arena.used, name.data(), length);
+    arena.used += length;
+    return ref;
+}
 
-    file.close();
-    cout << "Leaderboard updated and saved to 'leaderboard.csv'\n";
+NameRef internName(string_view name)
+{
+    return internName(playerNames, name);
 }
 
-// Ensure the main players CSV exists; create if missing.
-void ensureCSVExists(const string &filename = "players.csv")
+string_view nameText(const NameArena &arena, NameRef ref)
 {
-    ifstream infile(filename);
-    if (!infile.good())
+    return string_view(arena.blocks[ref.offset >> NAME_BLOCK_BITS].get() + (ref.offset & (NAME_BLOCK_SIZE - 1)), ref.length);
+}
+
+// Move all blocks of src to the end of dst. Returns the amount to add to the offset
+// of every NameRef made from src.
+uint32_t adoptArena(NameArena &dst, NameArena &src)
+{
+    uint32_t base = uint32_t(dst.blocks.size()) << NAME_BLOCK_BITS;
+    if (dst.blocks.size() + src.blocks.size() > NAME_MAX_BLOCKS)
+        throw length_error("player name arena is full");
+    for (auto &b : src.blocks)
+        dst.blocks.push_back(move(b));
+    if (!src.blocks.empty())
+        dst.used = src.used;
+    src.blocks.clear();
+    src.used = NAME_BLOCK_SIZE;
+    return base;
+}
+
+// Names interned into the arena while this is alive are released when it goes out of
+// scope, so boards that are only looked at (a history snapshot, a generated benchmark
+// workload) do not grow the arena for good. Nothing interned meanwhile may outlive it.
+struct TransientNames
+{
+    NameArena &arena;
+    size_t blocks;
+    uint32_t used;
+
+    TransientNames(NameArena &a = playerNames) : arena(a), blocks(a.blocks.size()), used(a.used) {}
+    ~TransientNames()
     {
-        ofstream outfile(filename);
-        outfile.close();
-        cout << "Created new file: " << filename << "\n";
+        arena.blocks.resize(blocks);
+        arena.used = used;
     }
+};
+
+// Bytes reserved by the arena.
+size_t arenaBytes(const NameArena &arena)
+{
+    return arena.blocks.size() * size_t(NAME_BLOCK_SIZE);
 }
 
-// Load players from players.csv into the provided vector.
-void loadPlayersFromCSV(vector<Player> &leaderboard, const string &filename = "players.csv")
+// Resident set size of this process in bytes (0 if unknown).
+size_t residentMemoryBytes()
 {
-    ifstream file(filename);
-    if (!file.is_open())
+#ifdef __linux__
+    ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    if (statm >> pages >> resident)
+        return resident * size_t(sysconf(_SC_PAGESIZE));
+#endif
+    return 0;
+}
+
+// Compact, trivially copyable player record: 12 bytes, cheap to swap in every sort kernel.
+struct Player
+{
+    NameRef name;
+    int score;
+};
+
+// Text of a player's name.
+string_view nameOf(const Player &p)
+{
+    return nameText(playerNames, p.name);
+}
+
+// -------------------- Hardware counters --------------------
+
+// Counter values for one measured region; -1 means the counter is unavailable.
+struct HardwareCounters
+{
+    int64_t cycles = -1;
+    int64_t instructions = -1;
+    int64_t l1dMisses = -1;
+    int64_t llcMisses = -1;
+    int64_t branchMisses = -1;
+};
+
+// Open perf_event file descriptors for one measured region.
+struct CounterSet
+{
+    int fds[5] = {-1, -1, -1, -1, -1};
+};
+
+// Open and enable cycles, instructions, L1D read misses, LLC misses and branch mispredictions
+// for this process (and threads it starts). Counters that cannot be opened stay at -1.
+CounterSet startCounters()
+{
+    CounterSet set;
+#ifdef __linux__
+    const pair<uint32_t, uint64_t> events[5] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    };
+    static bool warned = false;
+    for (int i = 0; i < 5; i++)
     {
-        cout << "Could not open " << filename << ".\n";
-        return;
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[i].first;
+        attr.config = events[i].second;
+        attr.disabled = 1;
+        attr.inherit = 1; // include worker threads of the parallel sorts
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        set.fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        if (set.fds[i] < 0 && i == 0 && !warned)
+        {
+            cout << "Hardware counters unavailable (perf_event_open: " << strerror(errno) << ")\n";
+            warned = true;
+        }
     }
+    for (int fd : set.fds)
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    return set;
+}
 
-    string line;
-    leaderboard.clear();
-    while (getline(file, line))
+// Disable, read and close the counters opened by startCounters.
+HardwareCounters stopCounters(CounterSet &set)
+{
+    int64_t values[5] = {-1, -1, -1, -1, -1};
+#ifdef __linux__
+    for (int i = 0; i < 5; i++)
     {
-        if (line.empty())
+        if (set.fds[i] < 0)
             continue;
-        stringstream ss(line);
-        string name;
-        int score;
-        getline(ss, name, ',');
-        ss >> score;
-        leaderboard.push_back({name, score});
+        ioctl(set.fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t v;
+        if (read(set.fds[i], &v, sizeof(v)) == sizeof(v))
+            values[i] = int64_t(v);
+        close(set.fds[i]);
+        set.fds[i] = -1;
     }
-    file.close();
+#endif
+    HardwareCounters c;
+    c.cycles = values[0];
+    c.instructions = values[1];
+    c.l1dMisses = values[2];
+    c.llcMisses = values[3];
+    c.branchMisses = values[4];
+    return c;
+}
 
-    cout << "Loaded " << leaderboard.size() << " players from " << filename << ".\n";
+// Counter value for tables: "n/a" when unavailable.
+string formatCounter(int64_t v)
+{
+    return v < 0 ? "n/a" : to_string(v);
 }
 
-// Append a single player record to players.csv.
-void appendPlayerToCSV(const Player &p, const string &filename = "players.csv")
+// Instructions per cycle, or "n/a".
+string formatIPC(const HardwareCounters &c)
 {
-    ofstream file(filename, ios::app);
-    if (!file.is_open())
-    {
-        cout << "Could not open " << filename << " for writing.\n";
-        return;
-    }
-    file << p.name << "," << p.score << "\n";
-    file.close();
+    if (c.cycles <= 0 || c.instructions < 0)
+        return "n/a";
+    ostringstream out;
+    out << fixed << setprecision(2) << double(c.instructions) / c.cycles;
+    return out.str();
 }
 
-// ------------------------------------------------------------------
+// One-line counter summary printed under a timed sort.
+void printCounters(const HardwareCounters &c)
+{
+    if (c.cycles < 0 && c.instructions < 0)
+        return;
+    cout << "Counters: cycles " << formatCounter(c.cycles) << " | instructions " << formatCounter(c.instructions)
+         << " | IPC " << formatIPC(c) << " | L1D misses " << formatCounter(c.l1dMisses)
+         << " | LLC misses " << formatCounter(c.llcMisses) << " | branch misses " << formatCounter(c.branchMisses) << "\n";
+}
 
-// Prototype for complexity info used by display functions.
-string getComplexityInfo(const string &algoName);
+struct ComparisonResult
+{
+    string algorithm;
+    double timeTaken;
+    string complexity;
+    HardwareCounters counters;
+};
 
-// -------------------- Display utilities --------------------
+// -------------------- Rank index --------------------
 
-// Display leaderboard vector in a formatted table and optionally show time/complexity.
-// Also saves the displayed leaderboard to CSV.
-void displayLeaderboard(const vector<Player> &lb, const string &algoName, double timeTaken = -1)
+// Order-statistic treap over leaderboard slots, ordered by score (desc), then name.
+// Every node keeps its subtree size, so rank queries never need a full sort.
+struct RankIndex
 {
-    cout << "\n==============================\n";
-    cout << "   " << algoName << " LEADERBOARD\n";
-    cout << "==============================\n";
-    cout << left << setw(6) << "Rank" << setw(20) << "Name" << setw(10) << "Score" << endl;
-    cout << "------------------------------\n";
-    for (int i = 0; i < lb.size(); i++)
-    {
-        cout << left << setw(6) << i + 1
-             << setw(20) << lb[i].name
-             << setw(10) << lb[i].score << endl;
-    }
-    cout << "==============================\n";
-    if (timeTaken >= 0)
+    struct Node
     {
-        cout << "Time taken: " << fixed << setprecision(3) << timeTaken << " ms\n";
-        cout << "Complexity: " << getComplexityInfo(algoName) << "\n";
-    }
+        int slot;
+        int left, right;
+        int size;
+        unsigned priority;
+    };
+    vector<Node> nodes;
+    int root = -1;
+    unsigned seed = 2463534242u;
+};
 
-    saveToCSV(lb, algoName);
+// True if the player in slot a ranks above the player in slot b.
+bool ranksBefore(const vector<Player> &lb, int a, int b)
+{
+    if (lb[a].score != lb[b].score)
+        return lb[a].score > lb[b].score;
+    string_view nameA = nameOf(lb[a]), nameB = nameOf(lb[b]);
+    if (nameA != nameB)
+        return nameA < nameB;
+    return a < b;
 }
 
-// -------------------- Sorting algorithms --------------------
+int treapSize(const RankIndex &idx, int t)
+{
+    return t < 0 ? 0 : idx.nodes[t].size;
+}
 
-// Bubble sort (descending by score).
-void bubbleSort(vector<Player> &lb)
+void treapUpdate(RankIndex &idx, int t)
 {
-    int n = lb.size();
-    for (int i = 0; i < n - 1; i++)
+    idx.nodes[t].size = 1 + treapSize(idx, idx.nodes[t].left) + treapSize(idx, idx.nodes[t].right);
+}
+
+// Insert node into subtree t, returning the new subtree root.
+int treapInsert(RankIndex &idx, const vector<Player> &lb, int t, int node)
+{
+    if (t < 0)
+        return node;
+
+    if (ranksBefore(lb, idx.nodes[node].slot, idx.nodes[t].slot))
     {
-        for (int j = 0; j < n - i - 1; j++)
+        int l = treapInsert(idx, lb, idx.nodes[t].left, node);
+        idx.nodes[t].left = l;
+        if (idx.nodes[l].priority > idx.nodes[t].priority)
         {
-            if (lb[j].score < lb[j + 1].score)
-                swap(lb[j], lb[j + 1]);
+            // Rotate right
+            idx.nodes[t].left = idx.nodes[l].right;
+            idx.nodes[l].right = t;
+            treapUpdate(idx, t);
+            treapUpdate(idx, l);
+            return l;
         }
     }
-}
-
-// Insertion sort (descending by score).
-void insertionSort(vector<Player> &lb)
-{
-    for (int i = 1; i < lb.size(); i++)
+    else
     {
-        Player key = lb[i];
-        int j = i - 1;
-        while (j >= 0 && lb[j].score < key.score)
+        int r = treapInsert(idx, lb, idx.nodes[t].right, node);
+        idx.nodes[t].right = r;
+        if (idx.nodes[r].priority > idx.nodes[t].priority)
         {
-            lb[j + 1] = lb[j];
-            j--;
+            // Rotate left
+            idx.nodes[t].right = idx.nodes[r].left;
+            idx.nodes[r].left = t;
+            treapUpdate(idx, t);
+            treapUpdate(idx, r);
+            return r;
         }
-        lb[j + 1] = key;
     }
+    treapUpdate(idx, t);
+    return t;
 }
 
-// Selection sort (descending by score).
-void selectionSort(vector<Player> &lb)
+// Add leaderboard slot to the rank index in O(log n) expected time.
+void rankInsert(RankIndex &idx, const vector<Player> &lb, int slot)
+{
+    // xorshift32 for treap priorities
+    idx.seed ^= idx.seed << 13;
+    idx.seed ^= idx.seed >> 17;
+    idx.seed ^= idx.seed << 5;
+
+    idx.nodes.push_back({slot, -1, -1, 1, idx.seed});
+    idx.root = treapInsert(idx, lb, idx.root, idx.nodes.size() - 1);
+}
+
+// Fix subtree sizes bottom-up after a bulk build (treap depth is O(log n) expected).
+int treapFixSizes(RankIndex &idx, int t)
+{
+    if (t < 0)
+        return 0;
+    idx.nodes[t].size = 1 + treapFixSizes(idx, idx.nodes[t].left) + treapFixSizes(idx, idx.nodes[t].right);
+    return idx.nodes[t].size;
+}
+
+// Build the rank index for every slot at once: sort slots by rank, then build the treap
+// as a Cartesian tree over the sorted order with a stack. O(n log n) comparisons and
+// sequential node writes instead of n random-access root-to-leaf inserts.
+void rankBuild(RankIndex &idx, const vector<Player> &lb)
 {
     int n = lb.size();
-    for (int i = 0; i < n - 1; i++)
+    vector<int> order(n);
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    sort(order.begin(), order.end(), [&](int a, int b)
+         { return ranksBefore(lb, a, b); });
+
+    idx.nodes.assign(n, RankIndex::Node());
+    vector<int> spine; // right spine of the tree built so far
+    for (int i = 0; i < n; i++)
     {
-        int maxIndex = i;
-        for (int j = i + 1; j < n; j++)
+        idx.seed ^= idx.seed << 13;
+        idx.seed ^= idx.seed >> 17;
+        idx.seed ^= idx.seed << 5;
+        idx.nodes[i] = {order[i], -1, -1, 1, idx.seed};
+
+        int last = -1;
+        while (!spine.empty() && idx.nodes[spine.back()].priority < idx.nodes[i].priority)
         {
-            if (lb[j].score > lb[maxIndex].score)
-                maxIndex = j;
+            last = spine.back();
+            spine.pop_back();
         }
-        swap(lb[i], lb[maxIndex]);
+        idx.nodes[i].left = last;
+        if (!spine.empty())
+            idx.nodes[spine.back()].right = i;
+        spine.push_back(i);
     }
+    idx.root = spine.empty() ? -1 : spine.front();
+    treapFixSizes(idx, idx.root);
 }
 
-// Merge helper for merge sort.
-void merge(vector<Player> &lb, int left, int mid, int right)
+// Join two subtrees where every node of a ranks before every node of b.
+int treapMerge(RankIndex &idx, int a, int b)
 {
-    int n1 = mid - left + 1, n2 = right - mid;
-    vector<Player> L(n1), R(n2);
-    for (int i = 0; i < n1; i++)
-        L[i] = lb[left + i];
-    for (int j = 0; j < n2; j++)
-        R[j] = lb[mid + 1 + j];
-    int i = 0, j = 0, k = left;
-    while (i < n1 && j < n2)
+    if (a < 0)
+        return b;
+    if (b < 0)
+        return a;
+    if (idx.nodes[a].priority > idx.nodes[b].priority)
     {
-        if (L[i].score >= R[j].score)
-            lb[k++] = L[i++];
-        else
-            lb[k++] = R[j++];
+        idx.nodes[a].right = treapMerge(idx, idx.nodes[a].right, b);
+        treapUpdate(idx, a);
+        return a;
     }
-    while (i < n1)
-        lb[k++] = L[i++];
-    while (j < n2)
-        lb[k++] = R[j++];
+    idx.nodes[b].left = treapMerge(idx, a, idx.nodes[b].left);
+    treapUpdate(idx, b);
+    return b;
 }
 
-// Merge sort (descending by score).
-void mergeSort(vector<Player> &lb, int left, int right)
+// Unlink the node holding slot from subtree t (located by its current rank key),
+// storing its index in removed. Returns the new subtree root.
+int treapErase(RankIndex &idx, const vector<Player> &lb, int t, int slot, int &removed)
 {
-    if (left < right)
+    if (t < 0)
+        return -1;
+    if (idx.nodes[t].slot == slot)
     {
-        int mid = left + (right - left) / 2;
-        mergeSort(lb, left, mid);
-        mergeSort(lb, mid + 1, right);
-        merge(lb, left, mid, right);
+        removed = t;
+        return treapMerge(idx, idx.nodes[t].left, idx.nodes[t].right);
     }
+    if (ranksBefore(lb, slot, idx.nodes[t].slot))
+        idx.nodes[t].left = treapErase(idx, lb, idx.nodes[t].left, slot, removed);
+    else
+        idx.nodes[t].right = treapErase(idx, lb, idx.nodes[t].right, slot, removed);
+    treapUpdate(idx, t);
+    return t;
 }
 
-// Partition used by quick sort (descending by score).
-int partition(vector<Player> &lb, int low, int high)
+// Set lb[slot].score and move the slot to its new rank in O(log n) expected time,
+// reusing its treap node.
+void rankUpdateScore(RankIndex &idx, vector<Player> &lb, int slot, int score)
 {
-    int pivot = lb[high].score;
-    int i = low - 1;
-    for (int j = low; j < high; j++)
+    int node = -1;
+    idx.root = treapErase(idx, lb, idx.root, slot, node);
+    lb[slot].score = score;
+    if (node < 0)
+        return;
+    idx.nodes[node].left = idx.nodes[node].right = -1;
+    idx.nodes[node].size = 1;
+    idx.root = treapInsert(idx, lb, idx.root, node);
+}
+
+// 1-based rank of the player stored in slot (0 if not indexed).
+int rankOf(const RankIndex &idx, const vector<Player> &lb, int slot)
+{
+    int t = idx.root, rank = 0;
+    while (t >= 0)
     {
-        if (lb[j].score >= pivot)
+        const RankIndex::Node &n = idx.nodes[t];
+        if (n.slot == slot)
+            return rank + treapSize(idx, n.left) + 1;
+        if (ranksBefore(lb, slot, n.slot))
+            t = n.left;
+        else
         {
-            i++;
-            swap(lb[i], lb[j]);
+            rank += treapSize(idx, n.left) + 1;
+            t = n.right;
         }
     }
-    swap(lb[i + 1], lb[high]);
-    return i + 1;
+    return 0;
 }
 
-// Quick sort (descending by score).
-void quickSort(vector<Player> &lb, int low, int high)
+// Leaderboard slot of the player holding the given 1-based rank (-1 if out of range).
+int playerAtRank(const RankIndex &idx, int rank)
 {
-    if (low < high)
+    int t = idx.root;
+    while (t >= 0)
     {
-        int pi = partition(lb, low, high);
-        quickSort(lb, low, pi - 1);
-        quickSort(lb, pi + 1, high);
+        int leftSize = treapSize(idx, idx.nodes[t].left);
+        if (rank <= leftSize)
+            t = idx.nodes[t].left;
+        else if (rank == leftSize + 1)
+            return idx.nodes[t].slot;
+        else
+        {
+            rank -= leftSize + 1;
+            t = idx.nodes[t].right;
+        }
     }
+    return -1;
 }
 
-// Heapify helper for heap sort.
-void heapify(vector<Player> &arr, int n, int i)
+// Collect slots ranked [from, to] (1-based, inclusive) from subtree t in rank order.
+void collectRankRange(const RankIndex &idx, int t, int offset, int from, int to, vector<int> &out)
 {
-    int largest = i;
-    int left = 2 * i + 1;
-    int right = 2 * i + 2;
+    if (t < 0 || offset + 1 > to || offset + idx.nodes[t].size < from)
+        return;
+    int leftSize = treapSize(idx, idx.nodes[t].left);
+    collectRankRange(idx, idx.nodes[t].left, offset, from, to, out);
+    int rank = offset + leftSize + 1;
+    if (rank >= from && rank <= to)
+        out.push_back(idx.nodes[t].slot);
+    collectRankRange(idx, idx.nodes[t].right, rank, from, to, out);
+}
 
-    if (left < n && arr[left].score > arr[largest].score)
-        largest = left;
+// Slots holding ranks [from, to] in O(log n + k).
+vector<int> rankRange(const RankIndex &idx, int from, int to)
+{
+    vector<int> out;
+    collectRankRange(idx, idx.root, 0, max(from, 1), to, out);
+    return out;
+}
 
-    if (right < n && arr[right].score > arr[largest].score)
-        largest = right;
+// -------------------- Name index --------------------
 
-    if (largest != i)
+// Open-addressing (linear probing) hash table from player name to leaderboard slot.
+// Entries carry the arena handle, so probes compare against interned bytes directly.
+struct NameIndex
+{
+    struct Entry
     {
-        swap(arr[i], arr[largest]);
-        heapify(arr, n, largest);
+        uint32_t hash;
+        int slot; // -1 = empty
+        NameRef name;
+    };
+    vector<Entry> table;
+    int count = 0;
+};
+
+// 32-bit FNV-1a hash of a name.
+uint32_t hashName(string_view name)
+{
+    uint32_t h = 2166136261u;
+    for (unsigned char c : name)
+    {
+        h ^= c;
+        h *= 16777619u;
     }
+    return h;
 }
 
-// Heap sort (descending by score).
-void heapSort(vector<Player> &arr)
+// Resize the table to hold at least n names at <= 50% load.
+void nameIndexReserve(NameIndex &idx, size_t n)
 {
-    int n = arr.size();
-    // Build max heap
-    for (int i = n / 2 - 1; i >= 0; i--)
-        heapify(arr, n, i);
+    size_t capacity = 16;
+    while (capacity < n * 2)
+        capacity *= 2;
+    if (capacity <= idx.table.size())
+        return;
 
-    // Extract elements from heap
-    for (int i = n - 1; i >= 0; i--)
+    vector<NameIndex::Entry> old = move(idx.table);
+    idx.table.assign(capacity, {0, -1, {0, 0}});
+    for (const auto &e : old)
     {
-        swap(arr[0], arr[i]);
-        heapify(arr, i, 0);
+        if (e.slot < 0)
+            continue;
+        size_t i = e.hash & (capacity - 1);
+        while (idx.table[i].slot >= 0)
+            i = (i + 1) & (capacity - 1);
+        idx.table[i] = e;
     }
-
-    // Reverse because we need descending (highest score first)
-    reverse(arr.begin(), arr.end());
 }
 
-// Counting sort for integer score range (descending).
-void countingSort(vector<Player> &arr)
+// Slot of the player with this exact name in O(1) expected time (-1 if absent).
+int nameLookup(const NameIndex &idx, string_view name)
 {
-    if (arr.empty())
-        return;
+    if (idx.table.empty())
+        return -1;
+    uint32_t h = hashName(name);
+    size_t mask = idx.table.size() - 1;
+    for (size_t i = h & mask; idx.table[i].slot >= 0; i = (i + 1) & mask)
+    {
+        if (idx.table[i].hash == h && nameText(playerNames, idx.table[i].name) == name)
+            return idx.table[i].slot;
+    }
+    return -1;
+}
 
-    int maxScore = arr[0].score, minScore = arr[0].score;
-    for (const auto &p : arr)
+// Map the name of leaderboard[slot] to slot (first occurrence wins).
+void nameInsert(NameIndex &idx, const vector<Player> &lb, int slot)
+{
+    string_view name = nameOf(lb[slot]);
+    nameIndexReserve(idx, idx.count + 1);
+    uint32_t h = hashName(name);
+    size_t mask = idx.table.size() - 1;
+    size_t i = h & mask;
+    for (; idx.table[i].slot >= 0; i = (i + 1) & mask)
     {
-        maxScore = max(maxScore, p.score);
-        minScore = min(minScore, p.score);
+        if (idx.table[i].hash == h && nameText(playerNames, idx.table[i].name) == name)
+            return; // duplicate name keeps its first slot
     }
+    idx.table[i] = {h, slot, lb[slot].name};
+    idx.count++;
+}
 
-    int range = maxScore - minScore + 1;
-    vector<int> count(range, 0);
+// Approximate heap bytes held by the name index.
+size_t nameIndexBytes(const NameIndex &idx)
+{
+    return idx.table.capacity() * sizeof(NameIndex::Entry);
+}
 
-    for (const auto &p : arr)
-        count[p.score - minScore]++;
+// -------------------- Prefix index --------------------
 
-    for (int i = range - 2; i >= 0; i--)
-        count[i] += count[i + 1]; // cumulative for descending
+// Compressed trie (radix tree) over player names for autocomplete and fuzzy search.
+// Edge labels are NameRefs into the player arena (a slice of the name that created the
+// edge), so the trie stores no text of its own. Children are kept in a sibling list
+// sorted by first byte, which makes a depth-first walk visit names in byte order.
+struct PrefixIndex
+{
+    struct Node
+    {
+        NameRef label;
+        int firstChild = -1;
+        int nextSibling = -1;
+        int slot = -1; // leaderboard slot of the name ending here
+    };
+    vector<Node> nodes = vector<Node>(1); // nodes[0] = root, empty label
+};
 
-    vector<Player> output(arr.size());
-    for (const auto &p : arr)
+// Number of suggestions the menu and the server return for a prefix or fuzzy search.
+const int SEARCH_SUGGESTIONS = 10;
+
+// Largest edit distance the menu and the server accept; beyond it the pruned walk
+// approaches a visit of the whole trie.
+const int FUZZY_MAX_DISTANCE = 3;
+
+// Longest query the menu and the server accept for a fuzzy search.
+const size_t FUZZY_MAX_QUERY_BYTES = 64;
+
+// Child of t whose label starts with byte c (-1 if none); prev gets the sibling before
+// that position, so a missing child can be linked in sorted order.
+int prefixChild(const PrefixIndex &idx, int t, unsigned char c, int &prev)
+{
+    prev = -1;
+    for (int ch = idx.nodes[t].firstChild; ch >= 0; ch = idx.nodes[ch].nextSibling)
     {
-        output[count[p.score - minScore] - 1] = p;
-        count[p.score - minScore]--;
+        unsigned char first = nameText(playerNames, idx.nodes[ch].label)[0];
+        if (first == c)
+            return ch;
+        if (first > c)
+            break;
+        prev = ch;
     }
+    return -1;
+}
 
-    arr = output;
+// Add the name of lb[slot] in O(name length); a duplicate name keeps its first slot.
+void prefixInsert(PrefixIndex &idx, const vector<Player> &lb, int slot)
+{
+    NameRef ref = lb[slot].name;
+    string_view name = nameText(playerNames, ref);
+    int t = 0;
+    size_t pos = 0;
+    while (pos < name.size())
+    {
+        int prev;
+        int child = prefixChild(idx, t, name[pos], prev);
+        if (child < 0)
+        {
+            // New leaf linked after prev
+            PrefixIndex::Node leaf;
+            leaf.label = {ref.offset + uint32_t(pos), uint32_t(name.size() - pos)};
+            leaf.slot = slot;
+            leaf.nextSibling = prev < 0 ? idx.nodes[t].firstChild : idx.nodes[prev].nextSibling;
+            idx.nodes.push_back(leaf);
+            (prev < 0 ? idx.nodes[t].firstChild : idx.nodes[prev].nextSibling) = idx.nodes.size() - 1;
+            return;
+        }
+
+        string_view label = nameText(playerNames, idx.nodes[child].label);
+        size_t common = 1;
+        while (common < label.size() && pos + common < name.size() && label[common] == name[pos + common])
+            common++;
+        if (common < label.size())
+        {
+            // Split the edge: a new node takes the shared part and child keeps the rest
+            PrefixIndex::Node mid;
+            mid.label = {idx.nodes[child].label.offset, uint32_t(common)};
+            mid.firstChild = child;
+            mid.nextSibling = idx.nodes[child].nextSibling;
+            idx.nodes.push_back(mid);
+            int m = idx.nodes.size() - 1;
+            (prev < 0 ? idx.nodes[t].firstChild : idx.nodes[prev].nextSibling) = m;
+            idx.nodes[child].label.offset += common;
+            idx.nodes[child].label.length -= common;
+            idx.nodes[child].nextSibling = -1;
+            child = m;
+        }
+        t = child;
+        pos += common;
+    }
+    if (idx.nodes[t].slot < 0)
+        idx.nodes[t].slot = slot;
 }
 
-// -------------------- Searching --------------------
+// Node whose subtree holds exactly the names starting with prefix (-1 if none): O(prefix).
+int prefixLocate(const PrefixIndex &idx, string_view prefix)
+{
+    int t = 0;
+    size_t pos = 0;
+    while (pos < prefix.size())
+    {
+        int prev;
+        t = prefixChild(idx, t, prefix[pos], prev);
+        if (t < 0)
+            return -1;
+        string_view label = nameText(playerNames, idx.nodes[t].label);
+        size_t n = min(label.size(), prefix.size() - pos);
+        if (label.compare(0, n, prefix.substr(pos, n)) != 0)
+            return -1;
+        pos += n;
+    }
+    return t;
+}
 
-// Linear search by exact name.
-int linearSearch(const vector<Player> &leaderboard, const string &name)
+// Slot of the player with exactly this name (-1 if absent): O(name length).
+int prefixLookup(const PrefixIndex &idx, string_view name)
 {
-    for (int i = 0; i < leaderboard.size(); i++)
+    int t = 0;
+    size_t pos = 0;
+    while (pos < name.size())
     {
-        if (leaderboard[i].name == name)
-            return i;
+        int prev;
+        t = prefixChild(idx, t, name[pos], prev);
+        if (t < 0)
+            return -1;
+        string_view label = nameText(playerNames, idx.nodes[t].label);
+        if (name.substr(pos, label.size()) != label)
+            return -1;
+        pos += label.size();
     }
-    return -1; // not found
+    return idx.nodes[t].slot;
 }
 
-// Binary search on sorted-by-name vector.
-int binarySearch(const vector<Player> &leaderboard, const string &name)
+// First limit slots (in name order) whose names start with prefix. Every non-final
+// node on the walk has at least two children or ends a name, so this is O(prefix + limit).
+vector<int> prefixMatches(const PrefixIndex &idx, string_view prefix, int limit)
 {
-    int low = 0, high = leaderboard.size() - 1;
+    vector<int> out;
+    int t = prefixLocate(idx, prefix);
+    if (t < 0 || limit <= 0)
+        return out;
+    vector<int> stack = {t};
+    while (!stack.empty() && int(out.size()) < limit)
+    {
+        int n = stack.back();
+        stack.pop_back();
+        if (idx.nodes[n].slot >= 0)
+            out.push_back(idx.nodes[n].slot);
+        if (n != t && idx.nodes[n].nextSibling >= 0)
+            stack.push_back(idx.nodes[n].nextSibling);
+        if (idx.nodes[n].firstChild >= 0)
+            stack.push_back(idx.nodes[n].firstChild);
+    }
+    return out;
+}
 
-    while (low <= high)
+// Walk the subtree under t carrying one Levenshtein row per consumed byte. A cell more
+// than maxDistance columns off the diagonal is already out of reach, so each row keeps
+// only the 2 * maxDistance + 1 cells of that band (values capped at maxDistance + 1) in a
+// flat buffer indexed by depth: memory is O(depth * maxDistance) whatever the query
+// length. Branches whose band minimum exceeds maxDistance are pruned.
+void collectFuzzy(const PrefixIndex &idx, int t, string_view query, int maxDistance, vector<int> &rows, size_t depth,
+                  vector<pair<int, int>> &out)
+{
+    const int far = maxDistance + 1;
+    const size_t width = 2 * maxDistance + 1;
+    for (int ch = idx.nodes[t].firstChild; ch >= 0; ch = idx.nodes[ch].nextSibling)
     {
-        int mid = low + (high - low) / 2;
+        string_view label = nameText(playerNames, idx.nodes[ch].label);
+        size_t d = depth;
+        bool alive = true;
+        for (size_t i = 0; i < label.size() && alive; i++, d++)
+        {
+            if (rows.size() < (d + 2) * width)
+                rows.resize((d + 2) * width);
+            const int *prevRow = &rows[d * width];
+            int *row = &rows[(d + 1) * width];
+            int best = far;
+            for (size_t k = 0; k < width; k++)
+            {
+                // cell k of row d + 1 is query column j; cell k of row d is column j - 1
+                long long j = (long long)(d + 1 + k) - maxDistance;
+                int v = far;
+                if (j == 0)
+                    v = int(min<size_t>(d + 1, far));
+                else if (j > 0 && j <= (long long)query.size())
+                {
+                    v = prevRow[k] + (query[j - 1] != label[i]);
+                    if (k + 1 < width)
+                        v = min(v, prevRow[k + 1] + 1);
+                    if (k > 0)
+                        v = min(v, row[k - 1] + 1);
+                    v = min(v, far);
+                }
+                row[k] = v;
+                best = min(best, v);
+            }
+            alive = best <= maxDistance;
+        }
+        if (!alive)
+            continue;
+        long long last = (long long)query.size() + maxDistance - (long long)d; // band cell of the final column
+        int distance = last >= 0 && last < (long long)width ? rows[d * width + last] : far;
+        if (idx.nodes[ch].slot >= 0 && distance <= maxDistance)
+            out.push_back({distance, idx.nodes[ch].slot});
+        collectFuzzy(idx, ch, query, maxDistance, rows, d, out);
+    }
+}
 
-        if (leaderboard[mid].name == name)
-            return mid;
-        else if (leaderboard[mid].name < name)
-            low = mid + 1;
-        else
-            high = mid - 1;
+// Up to limit (distance, slot) pairs for names within maxDistance edits of query,
+// closest first and then in name order.
+vector<pair<int, int>> fuzzyMatches(const PrefixIndex &idx, string_view query, int maxDistance, int limit)
+{
+    vector<pair<int, int>> out;
+    if (maxDistance < 0)
+        return out;
+    // band of row 0: cell k is column k - maxDistance, whose distance is the column itself
+    vector<int> rows(2 * maxDistance + 1, maxDistance + 1);
+    for (size_t j = 0; j <= min<size_t>(query.size(), maxDistance); j++)
+        rows[maxDistance + j] = j;
+    if (query.size() <= size_t(maxDistance) && idx.nodes[0].slot >= 0)
+        out.push_back({int(query.size()), idx.nodes[0].slot});
+    collectFuzzy(idx, 0, query, maxDistance, rows, 0, out);
+    // The walk is already in name order, so a stable sort by distance finishes the job
+    stable_sort(out.begin(), out.end(), [](auto &a, auto &b)
+                { return a.first < b.first; });
+    out.resize(min<size_t>(out.size(), max(limit, 0)));
+    return out;
+}
+
+// Plain O(|a|*|b|) Levenshtein distance; the full-scan baseline for fuzzyMatches.
+int editDistance(string_view a, string_view b)
+{
+    vector<int> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++)
+        row[j] = j;
+    for (size_t i = 1; i <= a.size(); i++)
+    {
+        int diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); j++)
+        {
+            int above = row[j];
+            row[j] = min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] != b[j - 1])});
+            diagonal = above;
+        }
     }
-    return -1; // not found
+    return row[b.size()];
 }
 
-// -------------------- Utilities --------------------
+// Approximate heap bytes held by the prefix index.
+size_t prefixIndexBytes(const PrefixIndex &idx)
+{
+    return idx.nodes.capacity() * sizeof(PrefixIndex::Node);
+}
 
-// Create a unique name if duplicate exists (adds " (n)").
-string generateUniqueName(const string &name, const vector<Player> &lb)
+// -------------------- Top-K queries --------------------
+
+// Size of the top-K heap maintained incrementally next to the leaderboard.
+const int STREAMING_TOP_K = 100;
+
+// Slots of the k best players via a bounded heap: O(n log k), no full sort.
+vector<int> topKHeap(const vector<Player> &lb, int k)
 {
-    int count = 0;
-    for (const auto &p : lb)
+    // Heap ordered by ranksBefore, so its front is the worst player kept so far
+    auto ranksFirst = [&lb](int a, int b)
+    { return ranksBefore(lb, a, b); };
+    vector<int> heap;
+    if (k <= 0)
+        return heap;
+    heap.reserve(min<size_t>(k, lb.size()));
+    for (int i = 0; i < int(lb.size()); i++)
     {
-        if (p.name == name || p.name.find(name + " (") == 0)
-            count++;
+        if (int(heap.size()) < k)
+        {
+            heap.push_back(i);
+            push_heap(heap.begin(), heap.end(), ranksFirst);
+        }
+        else if (ranksBefore(lb, i, heap.front()))
+        {
+            pop_heap(heap.begin(), heap.end(), ranksFirst);
+            heap.back() = i;
+            push_heap(heap.begin(), heap.end(), ranksFirst);
+        }
     }
-    if (count == 0)
+    sort_heap(heap.begin(), heap.end(), ranksFirst);
+    return heap;
+}
+
+// Slots of the k best players via introselect, then sorting only the winners: O(n + k log k).
+vector<int> topKSelect(const vector<Player> &lb, int k)
+{
+    auto ranksFirst = [&lb](int a, int b)
+    { return ranksBefore(lb, a, b); };
+    vector<int> slots(lb.size());
+    for (int i = 0; i < int(slots.size()); i++)
+        slots[i] = i;
+    k = max(0, min<int>(k, slots.size()));
+    nth_element(slots.begin(), slots.begin() + k, slots.end(), ranksFirst);
+    slots.resize(k);
+    sort(slots.begin(), slots.end(), ranksFirst);
+    return slots;
+}
+
+// Keep the STREAMING_TOP_K best slots as players arrive (heap front = worst kept).
+void streamingTopInsert(vector<int> &heap, const vector<Player> &lb, int slot)
+{
+    auto ranksFirst = [&lb](int a, int b)
+    { return ranksBefore(lb, a, b); };
+    if (heap.size() < STREAMING_TOP_K)
+    {
+        heap.push_back(slot);
+        push_heap(heap.begin(), heap.end(), ranksFirst);
+    }
+    else if (ranksBefore(lb, slot, heap.front()))
+    {
+        pop_heap(heap.begin(), heap.end(), ranksFirst);
+        heap.back() = slot;
+        push_heap(heap.begin(), heap.end(), ranksFirst);
+    }
+}
+
+// Best k slots from the streaming heap (k <= STREAMING_TOP_K): O(K log K), independent of n.
+vector<int> streamingTopK(const vector<int> &heap, const vector<Player> &lb, int k)
+{
+    vector<int> top = heap;
+    sort(top.begin(), top.end(), [&lb](int a, int b)
+         { return ranksBefore(lb, a, b); });
+    top.resize(min<size_t>(max(k, 0), top.size()));
+    return top;
+}
+
+// -------------------- Leaderboard index --------------------
+
+// All indexes that live next to the leaderboard and are kept in sync on insert.
+struct LeaderboardIndex
+{
+    RankIndex rank;
+    NameIndex names;
+    PrefixIndex prefixes;
+    vector<int> topHeap; // streaming top-K slots
+    unordered_map<string, int> nextSuffix; // base name -> next " (k)" suffix to try
+    double buildMs = 0; // time of the last full build
+};
+
+// Register the player stored in leaderboard[slot] with every index (rebuildIndex bulk-builds rank).
+void indexPlayer(LeaderboardIndex &index, const vector<Player> &lb, int slot, bool updateRank = true)
+{
+    if (updateRank)
+        rankInsert(index.rank, lb, slot);
+    nameInsert(index.names, lb, slot);
+    prefixInsert(index.prefixes, lb, slot);
+    streamingTopInsert(index.topHeap, lb, slot);
+
+    // "base (k)" moves the base's next suffix past k
+    string_view name = nameOf(lb[slot]);
+    size_t open = name.rfind(" (");
+    if (open != string::npos && name.size() > open + 3 && name.back() == ')')
+    {
+        string digits(name.substr(open + 2, name.size() - open - 3));
+        if (digits.size() < 10 && all_of(digits.begin(), digits.end(), [](unsigned char c)
+                                                  { return isdigit(c); }))
+        {
+            int &next = index.nextSuffix[string(name.substr(0, open))];
+            next = max(next, stoi(digits) + 1);
+        }
+    }
+}
+
+// Collision-free unique name in amortised O(1): the name itself if free, otherwise
+// "name (k)" for the base's next free suffix k. Suffixes only grow, so probing is bounded.
+string uniqueName(LeaderboardIndex &index, string_view requested)
+{
+    string name(requested);
+    if (nameLookup(index.names, name) == -1)
         return name;
-    else
-        return name + " (" + to_string(count) + ")";
+    int &next = index.nextSuffix[name];
+    next = max(next, 1);
+    string candidate = name + " (" + to_string(next) + ")";
+    while (nameLookup(index.names, candidate) != -1)
+        candidate = name + " (" + to_string(++next) + ")";
+    next++;
+    return candidate;
 }
 
-// Return complexity description for display.
-string getComplexityInfo(const string &algo)
+// Drop and rebuild all indexes from the leaderboard.
+void rebuildIndex(LeaderboardIndex &index, const vector<Player> &lb)
 {
-    if (algo == "Bubble Sort")
-        return "Time: O(n^2), Space: O(1)";
-    if (algo == "Insertion Sort")
-        return "Time: O(n^2), Space: O(1)";
-    if (algo == "Selection Sort")
-        return "Time: O(n^2), Space: O(1)";
-    if (algo == "Merge Sort")
-        return "Time: O(n log n), Space: O(n)";
-    if (algo == "Quick Sort")
-        return "Time: O(n log n) , O(n^2) , Space: O(log n)";
-    if (algo == "Heap Sort")
-        return "Time: O(n log n), Space: O(1)";
-    if (algo == "Counting Sort")
-        return "Time: O(n + k), Space: O(n + k)";
-    return "Unknown Complexity";
+    auto start = chrono::high_resolution_clock::now();
+    index = LeaderboardIndex();
+    rankBuild(index.rank, lb);
+    index.nextSuffix.reserve(lb.size() / 8);
+    nameIndexReserve(index.names, lb.size());
+    index.prefixes.nodes.reserve(2 * lb.size()); // a leaf per name plus at most one split each
+    for (int i = 0; i < int(lb.size()); i++)
+        indexPlayer(index, lb, i, false);
+    auto end = chrono::high_resolution_clock::now();
+    index.buildMs = chrono::duration<double, milli>(end - start).count();
+}
+
+// -------------------- Background writer (group commit) --------------------
+
+// All CSV and history persistence is queued to one writer thread, so the menu thread
+// never blocks on disk. Consecutive appends to the same file are coalesced into one
+// write() of up to syncBatch records, and dirty files are fsynced once syncBatch records
+// are unsynced or the oldest unsynced write is syncIntervalMs old (group commit).
+// flush() waits until everything queued so far is written and synced.
+struct PersistWriter
+{
+    struct Job
+    {
+        enum Kind
+        {
+            Append,  // append bytes to path
+            Replace, // atomically replace path with bytes (temp file + rename)
+            Task     // run task on the writer thread, then fsync syncPaths
+        } kind;
+        string path;
+        string bytes;
+        size_t records = 1;
+        bool freshLine = false; // Append: start on a new line if the file lacks a trailing newline
+        function<void()> task;
+        vector<string> syncPaths;
+    };
+
+    size_t syncBatch = 64;
+    int syncIntervalMs = 100;
+
+    // Writer-thread statistics (stable after flush())
+    uint64_t records = 0, bytes = 0, writeCalls = 0, syncCalls = 0;
+
+    mutex lock;
+    condition_variable wake, idle;
+    deque<Job> pending;
+    thread worker;
+    bool running = false, stopping = false, busy = false, dirty = false;
+    int flushWaiters = 0;
+    chrono::steady_clock::time_point dirtySince;
+
+    // Writer thread only: files written since the last sync and open append descriptors
+    unordered_map<string, int> appendFds;
+    vector<string> unsynced;
+    size_t unsyncedRecords = 0;
+
+    ~PersistWriter()
+    {
+        shutdown();
+    }
+
+    void submit(Job job)
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            if (!running)
+            {
+                running = true;
+                worker = thread([this]
+                                { run(); });
+            }
+            pending.push_back(move(job));
+        }
+        wake.notify_one();
+    }
+
+    void flush()
+    {
+        unique_lock<mutex> guard(lock);
+        if (!running)
+            return;
+        flushWaiters++;
+        wake.notify_one();
+        idle.wait(guard, [this]
+                  { return pending.empty() && !busy && !dirty; });
+        flushWaiters--;
+    }
+
+    // Flush, stop the thread and close descriptors; a later submit() restarts it.
+    void shutdown()
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            if (!running)
+                return;
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+        for (auto &f : appendFds)
+            closeFd(f.second);
+        appendFds.clear();
+        running = stopping = false;
+    }
+
+    void run()
+    {
+        unique_lock<mutex> guard(lock);
+        while (true)
+        {
+            if (!pending.empty())
+            {
+                deque<Job> batch;
+                batch.swap(pending);
+                busy = true;
+                guard.unlock();
+                for (size_t i = 0; i < batch.size();)
+                    i = process(batch, i);
+                guard.lock();
+                busy = false;
+                if (!dirty && !unsynced.empty())
+                    dirtySince = chrono::steady_clock::now();
+                dirty = !unsynced.empty();
+                continue;
+            }
+            auto deadline = dirtySince + chrono::milliseconds(syncIntervalMs);
+            if (dirty && (flushWaiters > 0 || stopping || chrono::steady_clock::now() >= deadline))
+            {
+                guard.unlock();
+                syncAll();
+                guard.lock();
+                dirty = false;
+                continue;
+            }
+            if (!dirty)
+            {
+                idle.notify_all();
+                if (stopping)
+                    return;
+                wake.wait(guard);
+            }
+            else
+                wake.wait_until(guard, deadline);
+        }
+    }
+
+    // Handle batch[i] plus any appends coalesced with it; returns the next index.
+    size_t process(deque<Job> &batch, size_t i)
+    {
+        Job &job = batch[i];
+        if (job.kind == Job::Task)
+        {
+            job.task();
+            markUnsynced(job.syncPaths, job.records);
+            return i + 1;
+        }
+        if (job.kind == Job::Replace)
+        {
+            string tmp = job.path + ".tmp";
+            if (writeBytes(tmp, job.bytes, false) && syncFile(tmp))
+            {
+                error_code ec;
+                filesystem::rename(tmp, job.path, ec);
+                if (ec)
+                    cout << "Background writer: could not replace " << job.path << ": " << ec.message() << "\n";
+                // a cached append descriptor still points at the replaced file
+                auto it = appendFds.find(job.path);
+                if (it != appendFds.end())
+                {
+                    closeFd(it->second);
+                    appendFds.erase(it);
+                }
+            }
+            records += job.records;
+            return i + 1;
+        }
+
+        size_t j = i, count = 0;
+        string buffer;
+        while (j < batch.size() && batch[j].kind == Job::Append && batch[j].path == job.path &&
+               (j == i || count + batch[j].records <= max<size_t>(syncBatch, 1)))
+        {
+            if (batch[j].freshLine)
+            {
+                char last = buffer.empty() ? lastByte(job.path) : buffer.back();
+                if (last != '\0' && last != '\n')
+                    buffer += '\n';
+            }
+            buffer += batch[j].bytes;
+            count += batch[j].records;
+            j++;
+        }
+        writeBytes(job.path, buffer, true);
+        markUnsynced({job.path}, count);
+        return j;
+    }
+
+    void markUnsynced(const vector<string> &paths, size_t count)
+    {
+        records += count;
+        for (const auto &p : paths)
+            if (find(unsynced.begin(), unsynced.end(), p) == unsynced.end())
+                unsynced.push_back(p);
+        unsyncedRecords += count;
+        if (unsyncedRecords >= syncBatch)
+            syncAll();
+    }
+
+    void syncAll()
+    {
+        for (const auto &p : unsynced)
+            syncFile(p);
+        unsynced.clear();
+        unsyncedRecords = 0;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    static void closeFd(int fd)
+    {
+        close(fd);
+    }
+
+    // One write() per call (retried only on short writes).
+    bool writeBytes(const string &path, const string &data, bool append)
+    {
+        int fd;
+        if (append)
+        {
+            auto it = appendFds.find(path);
+            if (it == appendFds.end())
+            {
+                fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+                if (fd < 0)
+                {
+                    cout << "Background writer: could not open " << path << "\n";
+                    return false;
+                }
+                it = appendFds.emplace(path, fd).first;
+            }
+            fd = it->second;
+        }
+        else
+        {
+            fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0)
+            {
+                cout << "Background writer: could not open " << path << "\n";
+                return false;
+            }
+        }
+        size_t done = 0;
+        while (done < data.size())
+        {
+            ssize_t n = write(fd, data.data() + done, data.size() - done);
+            writeCalls++;
+            if (n <= 0)
+            {
+                cout << "Background writer: write to " << path << " failed\n";
+                break;
+            }
+            done += n;
+        }
+        bytes += done;
+        if (!append)
+            close(fd);
+        return done == data.size();
+    }
+
+    bool syncFile(const string &path)
+    {
+        auto it = appendFds.find(path);
+        int fd = it != appendFds.end() ? it->second : open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        bool ok = fsync(fd) == 0;
+        syncCalls++;
+        if (it == appendFds.end())
+            close(fd);
+        return ok;
+    }
+
+    static char lastByte(const string &path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return '\0';
+        struct stat st;
+        char c = '\0';
+        if (fstat(fd, &st) == 0 && st.st_size > 0 && pread(fd, &c, 1, st.st_size - 1) != 1)
+            c = '\0';
+        close(fd);
+        return c;
+    }
+#else
+    static void closeFd(int) {}
+
+    // Portable fallback: buffered stream writes, no fsync available.
+    bool writeBytes(const string &path, const string &data, bool append)
+    {
+        ofstream file(path, ios::binary | (append ? ios::app : ios::trunc));
+        file.write(data.data(), data.size());
+        writeCalls++;
+        bytes += data.size();
+        if (!file)
+            cout << "Background writer: write to " << path << " failed\n";
+        return bool(file);
+    }
+
+    bool syncFile(const string &)
+    {
+        return true;
+    }
+
+    static char lastByte(const string &path)
+    {
+        ifstream file(path, ios::binary | ios::ate);
+        if (!file || file.tellg() <= 0)
+            return '\0';
+        file.seekg(-1, ios::end);
+        return char(file.get());
+    }
+#endif
+};
+
+PersistWriter persistWriter;
+
+// -------------------- Time-windowed leaderboards --------------------
+
+// Timestamped score submissions feed three boards: the current UTC day, the current
+// week (Monday to Sunday, UTC) and all time. Each board holds every player's best score
+// inside its window with its own name and rank index, updated in O(log n) per
+// submission. When a submission falls into a later window the board is emptied in one
+// step (containers keep their capacity), so nothing is ever rebuilt from a scan.
+// Submissions are appended to submissions.csv as name,score,unix_seconds.
+const string SUBMISSIONS_FILE = "submissions.csv";
+
+struct WindowBoard
+{
+    string label;
+    int64_t period;       // window length in seconds (0 = all-time, never expires)
+    int64_t offset;       // window start relative to the Unix epoch
+    int64_t current = -1; // window number currently held
+    vector<Player> entries;
+    NameIndex names;
+    RankIndex rank;
+    uint64_t submissions = 0, expiries = 0;
+
+    WindowBoard(string label, int64_t period, int64_t offset) : label(move(label)), period(period), offset(offset) {}
+};
+
+struct WindowedBoards
+{
+    // 1970-01-01 was a Thursday; weeks start on Monday 1970-01-05
+    WindowBoard boards[3] = {{"Daily", 86400, 0}, {"Weekly", 7 * 86400, 4 * 86400}, {"All-time", 0, 0}};
+};
+
+// Window number holding timestamp ts (floor division so pre-1970 times also work).
+int64_t windowOf(const WindowBoard &w, int64_t ts)
+{
+    if (w.period == 0)
+        return 0;
+    int64_t t = ts - w.offset;
+    return t / w.period - (t % w.period < 0);
+}
+
+// Drop every entry of the expired window at once.
+void expireWindow(WindowBoard &w, int64_t window)
+{
+    w.entries.clear();
+    fill(w.names.table.begin(), w.names.table.end(), NameIndex::Entry{0, -1, {0, 0}});
+    w.names.count = 0;
+    w.rank.nodes.clear();
+    w.rank.root = -1;
+    if (w.current >= 0)
+        w.expiries++;
+    w.current = window;
+}
+
+// Move every board on to the window holding now if that window has begun since the last
+// submission, so queries never serve a day or week that is already over.
+void rollWindows(WindowedBoards &wb, int64_t now)
+{
+    for (auto &w : wb.boards)
+    {
+        int64_t window = windowOf(w, now);
+        if (window > w.current)
+            expireWindow(w, window);
+    }
+}
+
+// Apply one submission to a board; returns the name handle it holds (reused by the
+// other boards so names are interned once). Submissions for expired windows are ignored.
+NameRef boardSubmit(WindowBoard &w, string_view name, const NameRef *ref, int score, int64_t ts)
+{
+    int64_t window = windowOf(w, ts);
+    if (window < w.current)
+        return ref ? *ref : internName(name);
+    if (window > w.current)
+        expireWindow(w, window);
+
+    w.submissions++;
+    int slot = nameLookup(w.names, name);
+    if (slot == -1)
+    {
+        w.entries.push_back({ref ? *ref : internName(name), score});
+        slot = w.entries.size() - 1;
+        nameInsert(w.names, w.entries, slot);
+        rankInsert(w.rank, w.entries, slot);
+    }
+    else if (score > w.entries[slot].score)
+        rankUpdateScore(w.rank, w.entries, slot, score);
+    return w.entries[slot].name;
+}
+
+void windowedSubmit(WindowedBoards &wb, string_view name, int score, int64_t ts)
+{
+    NameRef ref = boardSubmit(wb.boards[2], name, nullptr, score, ts);
+    boardSubmit(wb.boards[0], name, &ref, score, ts);
+    boardSubmit(wb.boards[1], name, &ref, score, ts);
+}
+
+// Approximate heap bytes held by one board.
+size_t windowBoardBytes(const WindowBoard &w)
+{
+    return w.entries.capacity() * sizeof(Player) + nameIndexBytes(w.names) +
+           w.rank.nodes.capacity() * sizeof(RankIndex::Node);
+}
+
+// Record a submission at the current time: update the boards and queue the CSV row.
+void recordSubmission(WindowedBoards &wb, const string &name, int score)
+{
+    int64_t now = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+    windowedSubmit(wb, name, score, now);
+
+    PersistWriter::Job job;
+    job.kind = PersistWriter::Job::Append;
+    job.path = SUBMISSIONS_FILE;
+    job.bytes = name + "," + to_string(score) + "," + to_string(now) + "\n";
+    job.freshLine = true;
+    persistWriter.submit(move(job));
+}
+
+// -------------------- File handling: CSV helpers --------------------
+
+// Leaderboard history is kept in an append-only data file plus a small sidecar index:
+//   leaderboard_history.idx : HistoryHeader, then one SnapshotInfo per snapshot
+//   leaderboard_history.dat : snapshot records (algorithm, row count, score and name columns)
+// Scores are stored as zigzag delta varints (sorted boards compress to ~1 byte per score),
+// so a save costs O(rows written) and snapshot N is read with two seeks.
+const string HISTORY_DATA_FILE = "leaderboard_history.dat";
+const string HISTORY_INDEX_FILE = "leaderboard_history.idx";
+
+struct HistoryHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t snapshots;
+    uint32_t reserved;
+    uint64_t totalRows;
+};
+
+struct SnapshotInfo
+{
+    uint64_t offset;    // byte offset of the record in the data file
+    uint64_t firstRank; // global row number of the first row (1-based)
+    uint32_t rows;
+    uint32_t bytes;
+};
+
+// Append an unsigned LEB128 varint.
+void putVarint(string &out, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        out += char((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    out += char(v);
+}
+
+// Read an unsigned LEB128 varint; returns false on truncated input.
+bool getVarint(const char *&p, const char *end, uint64_t &v)
+{
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7)
+    {
+        unsigned char b = *p++;
+        v |= uint64_t(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+// Read the history header; returns an empty header if the store does not exist yet.
+HistoryHeader readHistoryHeader()
+{
+    HistoryHeader h = {{'L', 'B', 'H', 'I'}, 1, 0, 0, 0};
+    ifstream idx(HISTORY_INDEX_FILE, ios::binary);
+    HistoryHeader onDisk;
+    if (idx.read(reinterpret_cast<char *>(&onDisk), sizeof(onDisk)) && memcmp(onDisk.magic, h.magic, 4) == 0)
+        h = onDisk;
+    return h;
+}
+
+// Append an encoded snapshot record and its index entry (runs on the background writer).
+void appendHistoryRecord(const string &record, uint32_t rows)
+{
+    HistoryHeader h = readHistoryHeader();
+    ofstream data(HISTORY_DATA_FILE, ios::binary | ios::app);
+    if (!data)
+    {
+        cout << "Error: Could not open " << HISTORY_DATA_FILE << "\n";
+        return;
+    }
+    data.seekp(0, ios::end);
+    SnapshotInfo info = {uint64_t(data.tellp()), h.totalRows + 1, rows, uint32_t(record.size())};
+    data.write(record.data(), record.size());
+    data.close();
+
+    // Data first, then index entry, then header: a crash never exposes a partial snapshot
+    if (h.snapshots == 0 && !filesystem::exists(HISTORY_INDEX_FILE))
+        ofstream(HISTORY_INDEX_FILE, ios::binary).write(reinterpret_cast<const char *>(&h), sizeof(h));
+    fstream idx(HISTORY_INDEX_FILE, ios::binary | ios::in | ios::out);
+    if (!idx)
+    {
+        cout << "Error: Could not open " << HISTORY_INDEX_FILE << "\n";
+        return;
+    }
+    idx.seekp(sizeof(HistoryHeader) + uint64_t(h.snapshots) * sizeof(SnapshotInfo));
+    idx.write(reinterpret_cast<const char *>(&info), sizeof(info));
+    h.snapshots++;
+    h.totalRows += rows;
+    idx.seekp(0);
+    idx.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    idx.close();
+}
+
+// Append one leaderboard snapshot to the history store in O(rows written). The record is
+// encoded here; the file updates run on the background writer.
+void saveSnapshot(const vector<Player> &lb, const string &algoName)
+{
+    // Encode the record: algorithm, rows, delta-coded score column, name column
+    string record;
+    putVarint(record, algoName.size());
+    record += algoName;
+    putVarint(record, lb.size());
+    int64_t prev = 0;
+    for (const auto &p : lb)
+    {
+        int64_t delta = int64_t(p.score) - prev;
+        putVarint(record, (uint64_t(delta) << 1) ^ uint64_t(delta >> 63)); // zigzag
+        prev = p.score;
+    }
+    for (const auto &p : lb)
+    {
+        string_view name = nameOf(p);
+        putVarint(record, name.size());
+        record += name;
+    }
+
+    PersistWriter::Job job;
+    job.kind = PersistWriter::Job::Task;
+    job.syncPaths = {HISTORY_DATA_FILE, HISTORY_INDEX_FILE};
+    job.task = [record = move(record), rows = uint32_t(lb.size())]
+    { appendHistoryRecord(record, rows); };
+    persistWriter.submit(move(job));
+    cout << "Leaderboard snapshot queued for '" << HISTORY_DATA_FILE << "'\n";
+}
+
+// Read snapshot n (1-based) back without scanning earlier snapshots.
+bool loadSnapshot(int n, vector<Player> &out, string &algoName, uint64_t &firstRank)
+{
+    persistWriter.flush();
+    HistoryHeader h = readHistoryHeader();
+    if (n < 1 || uint32_t(n) > h.snapshots)
+        return false;
+
+    SnapshotInfo info;
+    ifstream idx(HISTORY_INDEX_FILE, ios::binary);
+    idx.seekg(sizeof(HistoryHeader) + uint64_t(n - 1) * sizeof(SnapshotInfo));
+    if (!idx.read(reinterpret_cast<char *>(&info), sizeof(info)))
+        return false;
+
+    string record(info.bytes, '\0');
+    ifstream data(HISTORY_DATA_FILE, ios::binary);
+    data.seekg(info.offset);
+    if (!data.read(&record[0], record.size()))
+        return false;
+
+    const char *p = record.data(), *end = p + record.size();
+    uint64_t len, rows, v;
+    if (!getVarint(p, end, len) || uint64_t(end - p) < len)
+        return false;
+    algoName.assign(p, len);
+    p += len;
+    if (!getVarint(p, end, rows) || rows > uint64_t(end - p)) // every row takes at least one byte
+        return false;
+
+    out.assign(rows, Player());
+    int64_t prev = 0;
+    for (auto &pl : out)
+    {
+        if (!getVarint(p, end, v))
+            return false;
+        prev += int64_t(v >> 1) ^ -int64_t(v & 1);
+        pl.score = int(prev);
+    }
+    for (auto &pl : out)
+    {
+        if (!getVarint(p, end, len) || uint64_t(end - p) < len)
+            return false;
+        pl.name = internName(string_view(p, len));
+        p += len;
+    }
+    firstRank = info.firstRank;
+    return true;
+}
+
+// Ensure the main players CSV exists; create if missing.
+void ensureCSVExists(const string &filename = "players.csv")
+{
+    ifstream infile(filename);
+    if (!infile.good())
+    {
+        ofstream outfile(filename);
+        outfile.close();
+        cout << "Created new file: " << filename << "\n";
+    }
+}
+
+// Load players from players.csv into the provided vector (and index, if given).
+void loadPlayersFromCSV(vector<Player> &leaderboard, const string &filename = "players.csv", LeaderboardIndex *index = nullptr)
+{
+    auto start = chrono::high_resolution_clock::now();
+    ifstream file(filename);
+    if (!file.is_open())
+    {
+        cout << "Could not open " << filename << ".\n";
+        return;
+    }
+
+    string line;
+    leaderboard.clear();
+    while (getline(file, line))
+    {
+        if (line.empty())
+            continue;
+        stringstream ss(line);
+        string name;
+        int score;
+        getline(ss, name, ',');
+        ss >> score;
+        if (name.size() > MAX_NAME_BYTES)
+            continue;
+        leaderboard.push_back({internName(name), score});
+    }
+    file.close();
+
+    auto end = chrono::high_resolution_clock::now();
+    double seconds = chrono::duration<double>(end - start).count();
+    cout << "Loaded " << leaderboard.size() << " players from " << filename << " in " << fixed
+         << setprecision(3) << seconds * 1000 << " ms (" << setprecision(0)
+         << leaderboard.size() / max(seconds, 1e-9) << " rows/s).\n";
+
+    // Build indexes once for the whole file
+    if (index)
+        rebuildIndex(*index, leaderboard);
+    if (index)
+        cout << "Rank and name indexes built in " << setprecision(3) << index->buildMs << " ms.\n";
+}
+
+// -------------------- Fast parallel CSV loader --------------------
+
+// Read-only view of a whole file: mmap on POSIX, a heap copy elsewhere.
+struct FileView
+{
+    const char *data = nullptr;
+    size_t size = 0;
+    string buffer; // fallback storage when mmap is unavailable
+    bool mapped = false;
+};
+
+bool openFileView(FileView &view, const string &filename)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            madvise(p, st.st_size, MADV_SEQUENTIAL);
+            view.data = static_cast<const char *>(p);
+            view.size = st.st_size;
+            view.mapped = true;
+        }
+    }
+    close(fd);
+    if (view.mapped)
+        return true;
+#endif
+    ifstream file(filename, ios::binary);
+    if (!file.is_open())
+        return false;
+    view.buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    view.data = view.buffer.data();
+    view.size = view.buffer.size();
+    return true;
+}
+
+void closeFileView(FileView &view)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    if (view.mapped)
+        munmap(const_cast<char *>(view.data), view.size);
+#endif
+    view = FileView();
+}
+
+// Parse a decimal int (optional leading spaces and sign) from [p, end); 0 if no digits.
+int parseScore(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+    int64_t value = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        value = value * 10 + (*p++ - '0');
+        if (value > int64_t(numeric_limits<int>::max()) + 1)
+            break;
+    }
+    if (negative)
+        value = -value;
+    return int(max<int64_t>(numeric_limits<int>::min(), min<int64_t>(numeric_limits<int>::max(), value)));
+}
+
+// Parse all "name,score" lines in [begin, end) into out, skipping empty lines (LF or CRLF)
+// and names longer than MAX_NAME_BYTES.
+// Names are interned into arena, which must only be used by the calling thread.
+void parsePlayerChunk(const char *begin, const char *end, vector<Player> &out, NameArena &arena)
+{
+    size_t lines = 1;
+    for (const char *p = begin; (p = static_cast<const char *>(memchr(p, '\n', end - p))) != nullptr; p++)
+        lines++;
+    out.reserve(lines);
+
+    const char *p = begin;
+    while (p < end)
+    {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (!eol)
+            eol = end;
+        const char *last = eol; // line end without a CRLF '\r'
+        if (last != p && last[-1] == '\r')
+            last--;
+        const char *comma = static_cast<const char *>(memchr(p, ',', last - p));
+        if (last != p && size_t((comma ? comma : last) - p) <= MAX_NAME_BYTES)
+        {
+            if (comma)
+                out.push_back({internName(arena, string_view(p, comma - p)), parseScore(comma + 1, last)});
+            else
+                out.push_back({internName(arena, string_view(p, last - p)), 0});
+        }
+        p = eol + 1;
+    }
+}
+
+// Load players.csv by mapping it and parsing newline-aligned chunks on worker threads.
+void loadPlayersFromCSVParallel(vector<Player> &leaderboard, const string &filename = "players.csv", LeaderboardIndex *index = nullptr)
+{
+    auto start = chrono::high_resolution_clock::now();
+    size_t residentBefore = residentMemoryBytes();
+    FileView view;
+    if (!openFileView(view, filename))
+    {
+        cout << "Could not open " << filename << ".\n";
+        return;
+    }
+
+    // One chunk per hardware thread, but no chunk smaller than 1 MB
+    const size_t minChunk = 1 << 20;
+    size_t threads = max(1u, thread::hardware_concurrency());
+    threads = max<size_t>(1, min(threads, view.size / minChunk));
+
+    vector<const char *> bounds(threads + 1);
+    bounds[0] = view.data;
+    bounds[threads] = view.data + view.size;
+    for (size_t t = 1; t < threads; t++)
+    {
+        const char *p = view.data + view.size * t / threads;
+        p = max(p, bounds[t - 1]);
+        const char *eol = static_cast<const char *>(memchr(p, '\n', bounds[threads] - p));
+        bounds[t] = eol ? eol + 1 : bounds[threads];
+    }
+
+    // Each thread interns names into its own arena; blocks are adopted in file order afterwards
+    vector<vector<Player>> parts(threads);
+    vector<NameArena> arenas(threads);
+    vector<thread> workers;
+    for (size_t t = 1; t < threads; t++)
+        workers.emplace_back(parsePlayerChunk, bounds[t], bounds[t + 1], ref(parts[t]), ref(arenas[t]));
+    parsePlayerChunk(bounds[0], bounds[1], parts[0], arenas[0]);
+    for (auto &w : workers)
+        w.join();
+
+    size_t total = 0;
+    for (auto &part : parts)
+        total += part.size();
+    leaderboard.clear();
+    leaderboard.reserve(total);
+    for (size_t t = 0; t < threads; t++)
+    {
+        uint32_t base = adoptArena(playerNames, arenas[t]);
+        for (auto &p : parts[t])
+        {
+            p.name.offset += base;
+            leaderboard.push_back(p);
+        }
+        vector<Player>().swap(parts[t]);
+    }
+    closeFileView(view);
+
+    auto end = chrono::high_resolution_clock::now();
+    double seconds = chrono::duration<double>(end - start).count();
+    cout << "Loaded " << leaderboard.size() << " players from " << filename << " (mmap, " << threads
+         << " threads) in " << fixed << setprecision(3) << seconds * 1000 << " ms ("
+         << setprecision(0) << leaderboard.size() / max(seconds, 1e-9) << " rows/s).\n";
+    if (residentBefore)
+        cout << "Resident memory +" << setprecision(1) << (double(residentMemoryBytes()) - residentBefore) / (1 << 20)
+             << " MB (" << leaderboard.size() * sizeof(Player) / double(1 << 20) << " MB records, "
+             << arenaBytes(playerNames) / double(1 << 20) << " MB name arena).\n";
+
+    // Build indexes once for the whole file
+    if (index)
+    {
+        rebuildIndex(*index, leaderboard);
+        cout << "Rank and name indexes built in " << setprecision(3) << index->buildMs << " ms.\n";
+    }
+}
+
+// -------------------- Binary player snapshot --------------------
+
+// players.snap mirrors players.csv for fast startup (native endianness):
+//   PlayerSnapshotHeader | int32 scores[count] | uint32 nameEnds[count] | name bytes
+// nameEnds[i] is the end offset of name i in the name blob. The checksum covers
+// everything after the header. players.csv stays the interchange format; the snapshot
+// is only used while it is at least as new as the CSV.
+const string PLAYER_SNAPSHOT_FILE = "players.snap";
+const uint32_t PLAYER_SNAPSHOT_VERSION = 1;
+
+struct PlayerSnapshotHeader
+{
+    char magic[4]; // "LBPS"
+    uint32_t version;
+    uint64_t count;
+    uint64_t nameBytes;
+    uint64_t checksum;
+};
+
+// 64-bit multiplicative hash over 8-byte words (plus a byte tail).
+uint64_t snapshotChecksum(const char *data, size_t size)
+{
+    uint64_t h = 1469598103934665603ull;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ word) * 1099511628211ull;
+        h ^= h >> 29;
+    }
+    for (; i < size; i++)
+        h = (h ^ uint8_t(data[i])) * 1099511628211ull;
+    return h;
+}
+
+// Write the leaderboard to players.snap (via a temp file and rename).
+bool writePlayerSnapshot(const vector<Player> &lb, const string &filename = PLAYER_SNAPSHOT_FILE)
+{
+    persistWriter.flush(); // queued CSV appends must land first so the snapshot is the newer file
+    auto start = chrono::high_resolution_clock::now();
+    size_t n = lb.size(), nameBytes = 0;
+    for (const auto &p : lb)
+        nameBytes += p.name.length;
+
+    string payload(n * 8 + nameBytes, '\0');
+    char *scores = &payload[0], *ends = scores + n * 4, *names = ends + n * 4;
+    uint32_t end = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        string_view name = nameOf(lb[i]);
+        memcpy(names + end, name.data(), name.size());
+        end += name.size();
+        memcpy(scores + i * 4, &lb[i].score, 4);
+        memcpy(ends + i * 4, &end, 4);
+    }
+
+    PlayerSnapshotHeader h = {{'L', 'B', 'P', 'S'}, PLAYER_SNAPSHOT_VERSION, n, nameBytes,
+                              snapshotChecksum(payload.data(), payload.size())};
+    string tmp = filename + ".tmp";
+    {
+        ofstream file(tmp, ios::binary | ios::trunc);
+        if (!file)
+        {
+            cout << "Error: Could not open " << tmp << "\n";
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        file.write(payload.data(), payload.size());
+        if (!file)
+        {
+            cout << "Error: Could not write " << tmp << "\n";
+            return false;
+        }
+    }
+    error_code ec;
+    filesystem::rename(tmp, filename, ec);
+    if (ec)
+    {
+        cout << "Error: Could not replace " << filename << ": " << ec.message() << "\n";
+        return false;
+    }
+
+    double ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+    cout << "Binary snapshot of " << n << " players written to '" << filename << "' in "
+         << fixed << setprecision(3) << ms << " ms\n";
+    return true;
+}
+
+// True if the snapshot exists and is at least as new as the CSV it mirrors.
+bool playerSnapshotIsFresh(const string &csvFile = "players.csv", const string &snapFile = PLAYER_SNAPSHOT_FILE)
+{
+    error_code ec;
+    if (!filesystem::exists(snapFile, ec))
+        return false;
+    auto snapTime = filesystem::last_write_time(snapFile, ec);
+    if (ec)
+        return false;
+    auto csvTime = filesystem::last_write_time(csvFile, ec);
+    return ec || snapTime >= csvTime;
+}
+
+// Map players.snap, verify it, and load it; false (leaderboard untouched) if it is invalid.
+bool loadPlayerSnapshot(vector<Player> &leaderboard, LeaderboardIndex *index = nullptr, const string &filename = PLAYER_SNAPSHOT_FILE)
+{
+    auto start = chrono::high_resolution_clock::now();
+    FileView view;
+    if (!openFileView(view, filename))
+        return false;
+
+    PlayerSnapshotHeader h;
+    bool valid = view.size >= sizeof(h);
+    if (valid)
+    {
+        memcpy(&h, view.data, sizeof(h));
+        valid = memcmp(h.magic, "LBPS", 4) == 0 && h.version == PLAYER_SNAPSHOT_VERSION &&
+                h.count <= (view.size - sizeof(h)) / 8 &&
+                h.nameBytes == view.size - sizeof(h) - h.count * 8 &&
+                snapshotChecksum(view.data + sizeof(h), view.size - sizeof(h)) == h.checksum;
+    }
+    if (!valid)
+    {
+        cout << "Ignoring invalid " << filename << "\n";
+        closeFileView(view);
+        return false;
+    }
+
+    const char *scores = view.data + sizeof(h), *ends = scores + h.count * 4, *names = ends + h.count * 4;
+    vector<Player> loaded(h.count);
+    uint32_t begin = 0;
+    for (size_t i = 0; i < h.count; i++)
+    {
+        uint32_t end;
+        memcpy(&loaded[i].score, scores + i * 4, 4);
+        memcpy(&end, ends + i * 4, 4);
+        if (end < begin || end > h.nameBytes || end - begin > MAX_NAME_BYTES)
+        {
+            cout << "Ignoring corrupt " << filename << "\n";
+            closeFileView(view);
+            return false;
+        }
+        loaded[i].name = internName(string_view(names + begin, end - begin));
+        begin = end;
+    }
+    closeFileView(view);
+    leaderboard.swap(loaded);
+
+    double ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+    cout << "Loaded " << leaderboard.size() << " players from " << filename << " in " << fixed
+         << setprecision(3) << ms << " ms (" << setprecision(0) << leaderboard.size() / max(ms / 1000, 1e-9)
+         << " rows/s).\n";
+    if (index)
+    {
+        rebuildIndex(*index, leaderboard);
+        cout << "Rank and name indexes built in " << setprecision(3) << index->buildMs << " ms.\n";
+    }
+    return true;
+}
+
+// Split one name,score,unix_seconds row (name may contain commas); false for malformed rows.
+bool parseTimedSubmission(string_view line, string_view &name, int &score, int64_t &ts)
+{
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    // score and timestamp are the last two fields
+    size_t c2 = line.rfind(',');
+    size_t c1 = c2 == string_view::npos || c2 == 0 ? string_view::npos : line.rfind(',', c2 - 1);
+    if (c1 == string_view::npos || c1 == 0 || c1 > MAX_NAME_BYTES)
+        return false;
+    long long s = 0, t = 0;
+    auto r1 = from_chars(line.data() + c1 + 1, line.data() + c2, s);
+    auto r2 = from_chars(line.data() + c2 + 1, line.data() + line.size(), t);
+    if (r1.ec != errc() || r2.ec != errc() || s < numeric_limits<int>::min() || s > numeric_limits<int>::max())
+        return false;
+    name = line.substr(0, c1);
+    score = int(s);
+    ts = t;
+    return true;
+}
+
+// Logs shorter than this are never compacted.
+const size_t SUBMISSIONS_COMPACT_MIN = 4096;
+
+// Rows of submissions.csv that still affect a board once the boards are loaded: every row
+// of the current week (it feeds the daily and weekly boards) plus, for the all-time board,
+// the first row carrying each player's best score. Replaying just these rows in log order
+// rebuilds the same three boards.
+string liveSubmissionRows(const WindowedBoards &wb, string_view log, size_t &kept)
+{
+    const WindowBoard &weekly = wb.boards[1], &allTime = wb.boards[2];
+    vector<char> bestKept(allTime.entries.size(), 0);
+    string out;
+    kept = 0;
+    const char *p = log.data(), *end = log.data() + log.size();
+    while (p < end)
+    {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+        string_view line(p, (eol ? eol : end) - p);
+        p = eol ? eol + 1 : end;
+        string_view name;
+        int score;
+        int64_t ts;
+        if (!parseTimedSubmission(line, name, score, ts))
+            continue;
+        int slot = nameLookup(allTime.names, name);
+        bool best = slot >= 0 && !bestKept[slot] && score == allTime.entries[slot].score;
+        if (!best && windowOf(weekly, ts) < weekly.current)
+            continue;
+        if (best)
+            bestKept[slot] = 1;
+        out.append(line.data(), line.size()).push_back('\n');
+        kept++;
+    }
+    return out;
+}
+
+// Replay submissions.csv into the boards (expired windows drop out as it streams). Once
+// most of the log is rows of past weeks that no longer set anyone's all-time best, the
+// file is rewritten with only the live rows, so startup replay stays proportional to
+// players plus this week's submissions instead of the whole history.
+void loadSubmissions(WindowedBoards &wb, const string &filename = SUBMISSIONS_FILE)
+{
+    FileView view;
+    if (!openFileView(view, filename))
+        return;
+    auto start = chrono::high_resolution_clock::now();
+    size_t rows = 0;
+    const char *p = view.data, *end = view.data + view.size;
+    while (p < end)
+    {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+        string_view line(p, (eol ? eol : end) - p);
+        p = eol ? eol + 1 : end;
+        string_view name;
+        int score;
+        int64_t ts;
+        if (!parseTimedSubmission(line, name, score, ts))
+            continue;
+        windowedSubmit(wb, name, score, ts);
+        rows++;
+    }
+    rollWindows(wb, chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count());
+
+    size_t kept = rows;
+    if (rows >= SUBMISSIONS_COMPACT_MIN && rows >= 2 * wb.boards[2].entries.size())
+    {
+        string live = liveSubmissionRows(wb, string_view(view.data, view.size), kept);
+        if (kept <= rows / 2)
+        {
+            PersistWriter::Job job;
+            job.kind = PersistWriter::Job::Replace;
+            job.path = filename;
+            job.bytes = move(live);
+            job.records = kept;
+            persistWriter.submit(move(job));
+        }
+        else
+            kept = rows;
+    }
+    closeFileView(view);
+    double ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+    cout << "Replayed " << rows << " timestamped submissions in " << fixed << setprecision(3) << ms << " ms.\n";
+    if (kept < rows)
+        cout << "Compacting " << filename << ": keeping " << kept << " live rows.\n";
+}
+
+// Queue a single player record for players.csv on the background writer.
+void appendPlayerToCSV(const Player &p, const string &filename = "players.csv")
+{
+    PersistWriter::Job job;
+    job.kind = PersistWriter::Job::Append;
+    job.path = filename;
+    job.bytes = string(nameOf(p)) + "," + to_string(p.score) + "\n";
+    job.freshLine = true;
+    persistWriter.submit(move(job));
+}
+
+// ------------------------------------------------------------------
+
+// Prototype for complexity info used by display functions.
+string getComplexityInfo(const string &algoName);
+
+// -------------------- Display utilities --------------------
+
+// Rows shown per leaderboard view (0 = whole board); set with --page-size.
+size_t viewPageSize = 0;
+
+// Append every displayed leaderboard to the history store; --no-view-history defers
+// that to an explicit save so a view costs only the rows it prints.
+bool viewHistory = true;
+
+// Append text left-aligned in a field of width (like setw + left; never truncates).
+void appendPadded(string &out, string_view text, size_t width)
+{
+    out.append(text);
+    if (text.size() < width)
+        out.append(width - text.size(), ' ');
+}
+
+void appendPadded(string &out, long long value, size_t width)
+{
+    char digits[24];
+    auto res = to_chars(digits, digits + sizeof(digits), value);
+    appendPadded(out, string_view(digits, res.ptr - digits), width);
+}
+
+// Print count ranked rows (rank firstRank + i is rowAt(i), a (name, score) pair) as one
+// buffered write: the rows are formatted into a single preallocated string instead of
+// per-field iostream formatting with a flush on every line.
+template <typename RowAt>
+void printBoardRows(size_t firstRank, size_t count, RowAt rowAt)
+{
+    string out;
+    out.reserve(96 + count * 40);
+    out += "Rank  Name                Score     \n";
+    out += "------------------------------\n";
+    for (size_t i = 0; i < count; i++)
+    {
+        pair<string_view, int> row = rowAt(i);
+        appendPadded(out, (long long)(firstRank + i), 6);
+        appendPadded(out, row.first, 20);
+        appendPadded(out, row.second, 10);
+        out += '\n';
+    }
+    out += "==============================\n";
+    cout.write(out.data(), out.size());
+}
+
+// Display leaderboard vector in a formatted table and optionally show time/complexity.
+// Shows the first viewPageSize rows (all when 0) and, unless --no-view-history, appends
+// the displayed leaderboard to the history store.
+void displayLeaderboard(const vector<Player> &lb, const string &algoName, double timeTaken = -1)
+{
+    cout << "\n==============================\n";
+    cout << "   " << algoName << " LEADERBOARD\n";
+    cout << "==============================\n";
+    size_t shown = viewPageSize ? min(viewPageSize, lb.size()) : lb.size();
+    printBoardRows(1, shown, [&](size_t i)
+                   { return make_pair(nameOf(lb[i]), lb[i].score); });
+    if (shown < lb.size())
+        cout << "Showing ranks 1-" << shown << " of " << lb.size() << " (option 7 browses other ranks)\n";
+    if (timeTaken >= 0)
+    {
+        cout << "Time taken: " << fixed << setprecision(3) << timeTaken << " ms\n";
+        cout << "Complexity: " << getComplexityInfo(algoName) << "\n";
+    }
+
+    if (viewHistory)
+        saveSnapshot(lb, algoName);
+}
+
+// Display leaderboard rows for the given slots, numbered from firstRank.
+void displayRankRange(const vector<Player> &lb, const vector<int> &slots, int firstRank)
+{
+    cout << "\n==============================\n";
+    printBoardRows(firstRank, slots.size(), [&](size_t i)
+                   { return make_pair(nameOf(lb[slots[i]]), lb[slots[i]].score); });
+}
+
+// -------------------- Sorting algorithms --------------------
+
+// Bubble sort (descending by score).
+template <typename T>
+void bubbleSort(vector<T> &lb)
+{
+    int n = lb.size();
+    for (int i = 0; i < n - 1; i++)
+    {
+        for (int j = 0; j < n - i - 1; j++)
+        {
+            if (lb[j].score < lb[j + 1].score)
+                swap(lb[j], lb[j + 1]);
+        }
+    }
+}
+
+// Insertion sort (descending by score).
+template <typename T>
+void insertionSort(vector<T> &lb)
+{
+    for (int i = 1; i < lb.size(); i++)
+    {
+        T key = lb[i];
+        int j = i - 1;
+        while (j >= 0 && lb[j].score < key.score)
+        {
+            lb[j + 1] = lb[j];
+            j--;
+        }
+        lb[j + 1] = key;
+    }
+}
+
+// Selection sort (descending by score).
+template <typename T>
+void selectionSort(vector<T> &lb)
+{
+    int n = lb.size();
+    for (int i = 0; i < n - 1; i++)
+    {
+        int maxIndex = i;
+        for (int j = i + 1; j < n; j++)
+        {
+            if (lb[j].score > lb[maxIndex].score)
+                maxIndex = j;
+        }
+        swap(lb[i], lb[maxIndex]);
+    }
+}
+
+// Merge helper for merge sort.
+template <typename T>
+void merge(vector<T> &lb, int left, int mid, int right)
+{
+    int n1 = mid - left + 1, n2 = right - mid;
+    vector<T> L(n1), R(n2);
+    for (int i = 0; i < n1; i++)
+        L[i] = lb[left + i];
+    for (int j = 0; j < n2; j++)
+        R[j] = lb[mid + 1 + j];
+    int i = 0, j = 0, k = left;
+    while (i < n1 && j < n2)
+    {
+        if (L[i].score >= R[j].score)
+            lb[k++] = L[i++];
+        else
+            lb[k++] = R[j++];
+    }
+    while (i < n1)
+        lb[k++] = L[i++];
+    while (j < n2)
+        lb[k++] = R[j++];
+}
+
+// Merge sort (descending by score).
+template <typename T>
+void mergeSort(vector<T> &lb, int left, int right)
+{
+    if (left < right)
+    {
+        int mid = left + (right - left) / 2;
+        mergeSort(lb, left, mid);
+        mergeSort(lb, mid + 1, right);
+        merge(lb, left, mid, right);
+    }
+}
+
+// Partition used by quick sort (descending by score).
+template <typename T>
+int partition(vector<T> &lb, int low, int high)
+{
+    int pivot = lb[high].score;
+    int i = low - 1;
+    for (int j = low; j < high; j++)
+    {
+        if (lb[j].score >= pivot)
+        {
+            i++;
+            swap(lb[i], lb[j]);
+        }
+    }
+    swap(lb[i + 1], lb[high]);
+    return i + 1;
+}
+
+// Quick sort (descending by score).
+template <typename T>
+void quickSort(vector<T> &lb, int low, int high)
+{
+    if (low < high)
+    {
+        int pi = partition(lb, low, high);
+        quickSort(lb, low, pi - 1);
+        quickSort(lb, pi + 1, high);
+    }
+}
+
+// Heapify helper for heap sort.
+template <typename T>
+void heapify(vector<T> &arr, int n, int i)
+{
+    int largest = i;
+    int left = 2 * i + 1;
+    int right = 2 * i + 2;
+
+    if (left < n && arr[left].score > arr[largest].score)
+        largest = left;
+
+    if (right < n && arr[right].score > arr[largest].score)
+        largest = right;
+
+    if (largest != i)
+    {
+        swap(arr[i], arr[largest]);
+        heapify(arr, n, largest);
+    }
+}
+
+// Heap sort (descending by score).
+template <typename T>
+void heapSort(vector<T> &arr)
+{
+    int n = arr.size();
+    // Build max heap
+    for (int i = n / 2 - 1; i >= 0; i--)
+        heapify(arr, n, i);
+
+    // Extract elements from heap
+    for (int i = n - 1; i >= 0; i--)
+    {
+        swap(arr[0], arr[i]);
+        heapify(arr, i, 0);
+    }
+
+    // Reverse because we need descending (highest score first)
+    reverse(arr.begin(), arr.end());
+}
+
+// Counting sort for integer score range (descending).
+template <typename T>
+void countingSort(vector<T> &arr)
+{
+    if (arr.empty())
+        return;
+
+    int maxScore = arr[0].score, minScore = arr[0].score;
+    for (const auto &p : arr)
+    {
+        maxScore = max(maxScore, p.score);
+        minScore = min(minScore, p.score);
+    }
+
+    int range = maxScore - minScore + 1;
+    vector<int> count(range, 0);
+
+    for (const auto &p : arr)
+        count[p.score - minScore]++;
+
+    for (int i = range - 2; i >= 0; i--)
+        count[i] += count[i + 1]; // cumulative for descending
+
+    vector<T> output(arr.size());
+    for (const auto &p : arr)
+    {
+        output[count[p.score - minScore] - 1] = p;
+        count[p.score - minScore]--;
+    }
+
+    arr = output;
+}
+
+// LSD radix sort on score bytes (descending, stable, full int range).
+// Scores are mapped to unsigned keys whose ascending order is descending score order,
+// all four byte histograms are built in one pass over the contiguous key column, and
+// each non-trivial byte is scattered between lb and a single ping-pong buffer.
+template <typename T>
+void radixSort(vector<T> &arr)
+{
+    size_t n = arr.size();
+    if (n < 2)
+        return;
+
+    vector<uint32_t> keys(n), keysTmp(n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] = ~(uint32_t(arr[i].score) ^ 0x80000000u); // flip sign for order, invert for descending
+
+    uint32_t count[4][256] = {};
+    for (size_t i = 0; i < n; i++)
+    {
+        uint32_t k = keys[i];
+        count[0][k & 0xFF]++;
+        count[1][(k >> 8) & 0xFF]++;
+        count[2][(k >> 16) & 0xFF]++;
+        count[3][k >> 24]++;
+    }
+
+    vector<T> buffer(n);
+    vector<T> *src = &arr, *dst = &buffer;
+    vector<uint32_t> *srcKeys = &keys, *dstKeys = &keysTmp;
+    for (int pass = 0; pass < 4; pass++)
+    {
+        int shift = pass * 8;
+        if (count[pass][((*srcKeys)[0] >> shift) & 0xFF] == n)
+            continue; // every key shares this byte
+
+        uint32_t offset[256], sum = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            offset[b] = sum;
+            sum += count[pass][b];
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            uint32_t pos = offset[((*srcKeys)[i] >> shift) & 0xFF]++;
+            (*dstKeys)[pos] = (*srcKeys)[i];
+            (*dst)[pos] = move((*src)[i]);
+        }
+        swap(src, dst);
+        swap(srcKeys, dstKeys);
+    }
+
+    if (src != &arr)
+        arr.swap(buffer);
+}
+
+// Index of the median score among lb[a], lb[b], lb[c].
+template <typename T>
+int medianOfThree(const vector<T> &lb, int a, int b, int c)
+{
+    int x = lb[a].score, y = lb[b].score, z = lb[c].score;
+    if (x < y)
+        return y < z ? b : (x < z ? c : a);
+    return x < z ? a : (y < z ? c : b);
+}
+
+// Insertion sort of lb[low, high] (descending by score).
+template <typename T>
+void insertionSortRange(vector<T> &lb, int low, int high)
+{
+    for (int i = low + 1; i <= high; i++)
+    {
+        T key = lb[i];
+        int j = i - 1;
+        while (j >= low && lb[j].score < key.score)
+        {
+            lb[j + 1] = lb[j];
+            j--;
+        }
+        lb[j + 1] = key;
+    }
+}
+
+// Heap sort of lb[low, high] (descending by score), used when introSort goes too deep.
+template <typename T>
+void heapSortRange(vector<T> &lb, int low, int high)
+{
+    int n = high - low + 1;
+    // Min-heap on score, so extracting to the back leaves the range in descending order
+    auto sift = [&](int i, int size)
+    {
+        while (true)
+        {
+            int smallest = i, l = 2 * i + 1, r = 2 * i + 2;
+            if (l < size && lb[low + l].score < lb[low + smallest].score)
+                smallest = l;
+            if (r < size && lb[low + r].score < lb[low + smallest].score)
+                smallest = r;
+            if (smallest == i)
+                return;
+            swap(lb[low + i], lb[low + smallest]);
+            i = smallest;
+        }
+    };
+    for (int i = n / 2 - 1; i >= 0; i--)
+        sift(i, n);
+    for (int i = n - 1; i > 0; i--)
+    {
+        swap(lb[low], lb[low + i]);
+        sift(0, i);
+    }
+}
+
+// Ranges at or below this size are finished with insertion sort.
+const int INTRO_INSERTION_CUTOFF = 16;
+
+// Three-way partition of lb[low, high] around a median-of-three pivot (Tukey's ninther on
+// larger ranges): afterwards [low, lt) > pivot, [lt, gt] == pivot and (gt, high] < pivot.
+template <typename T>
+void partitionThreeWay(vector<T> &lb, int low, int high, int &lt, int &gt)
+{
+    int n = high - low + 1, mid = low + n / 2;
+    int m;
+    if (n > 128)
+    {
+        int s = n / 8;
+        m = medianOfThree(lb, medianOfThree(lb, low, low + s, low + 2 * s),
+                          medianOfThree(lb, mid - s, mid, mid + s),
+                          medianOfThree(lb, high - 2 * s, high - s, high));
+    }
+    else
+        m = medianOfThree(lb, low, mid, high);
+    int pivot = lb[m].score;
+
+    int i = low;
+    lt = low;
+    gt = high;
+    while (i <= gt)
+    {
+        if (lb[i].score > pivot)
+            swap(lb[lt++], lb[i++]);
+        else if (lb[i].score < pivot)
+            swap(lb[i], lb[gt--]);
+        else
+            i++;
+    }
+}
+
+template <typename T>
+void introSortRange(vector<T> &lb, int low, int high, int depthLimit)
+{
+    while (high - low + 1 > INTRO_INSERTION_CUTOFF)
+    {
+        if (depthLimit-- == 0)
+        {
+            heapSortRange(lb, low, high);
+            return;
+        }
+
+        int lt, gt;
+        partitionThreeWay(lb, low, high, lt, gt);
+
+        // Recurse into the smaller side and loop on the larger, so the stack stays O(log n)
+        if (lt - low < high - gt)
+        {
+            introSortRange(lb, low, lt - 1, depthLimit);
+            low = gt + 1;
+        }
+        else
+        {
+            introSortRange(lb, gt + 1, high, depthLimit);
+            high = lt - 1;
+        }
+    }
+    insertionSortRange(lb, low, high);
+}
+
+// Introsort-style quick sort (descending by score): ninther pivots, three-way partitioning
+// for duplicate scores, insertion sort on small ranges and heap sort past 2*log2(n) depth.
+template <typename T>
+void introSort(vector<T> &lb)
+{
+    int depthLimit = 0;
+    for (size_t n = lb.size(); n > 1; n >>= 1)
+        depthLimit += 2;
+    introSortRange(lb, 0, int(lb.size()) - 1, depthLimit);
+}
+
+// Number of leading elements of [first, first + n) satisfying pred (all true, then all false),
+// found by exponential then binary search in O(log k) for an answer of k.
+template <typename It, typename Pred>
+int gallop(It first, int n, Pred pred)
+{
+    int lo = 0, hi = 1;
+    while (hi <= n && pred(first[hi - 1]))
+    {
+        lo = hi;
+        hi = hi * 2 + 1;
+    }
+    return partition_point(first + lo, first + min(hi, n), pred) - first;
+}
+
+// Stable binary insertion of lb[sortedEnd, end) into the sorted prefix lb[low, sortedEnd).
+template <typename T>
+void binaryInsertionSort(vector<T> &lb, int low, int sortedEnd, int end)
+{
+    for (int i = sortedEnd; i < end; i++)
+    {
+        T key = move(lb[i]);
+        auto pos = partition_point(lb.begin() + low, lb.begin() + i, [&key](const T &p)
+                                   { return p.score >= key.score; });
+        move_backward(pos, lb.begin() + i, lb.begin() + i + 1);
+        *pos = move(key);
+    }
+}
+
+// Consecutive wins by one side before a merge switches to galloping.
+const int MIN_GALLOP = 7;
+
+// Stable merge of adjacent sorted runs lb[start, mid) and lb[mid, end) using scratch.
+template <typename T>
+void timMerge(vector<T> &lb, vector<T> &scratch, int start, int mid, int end)
+{
+    // Left elements that already precede right[0], and right elements that already
+    // follow left's last element, stay where they are
+    start += gallop(lb.begin() + start, mid - start, [key = lb[mid].score](const T &p)
+                    { return p.score >= key; });
+    if (start == mid)
+        return;
+    end = mid + gallop(lb.begin() + mid, end - mid, [key = lb[mid - 1].score](const T &p)
+                       { return p.score > key; });
+
+    // Merge forward with the left run moved out to scratch
+    int n1 = mid - start;
+    move(lb.begin() + start, lb.begin() + mid, scratch.begin());
+    int i = 0, j = mid, k = start;
+    int leftWins = 0, rightWins = 0;
+    while (i < n1 && j < end)
+    {
+        if (leftWins >= MIN_GALLOP || rightWins >= MIN_GALLOP)
+        {
+            // Galloping: copy whole stretches located by exponential search
+            int a = gallop(scratch.begin() + i, n1 - i, [key = lb[j].score](const T &p)
+                           { return p.score >= key; });
+            move(scratch.begin() + i, scratch.begin() + i + a, lb.begin() + k);
+            i += a;
+            k += a;
+            if (i == n1)
+                break;
+            int b = gallop(lb.begin() + j, end - j, [key = scratch[i].score](const T &p)
+                           { return p.score > key; });
+            move(lb.begin() + j, lb.begin() + j + b, lb.begin() + k);
+            j += b;
+            k += b;
+            if (a < MIN_GALLOP && b < MIN_GALLOP)
+                leftWins = rightWins = 0;
+            continue;
+        }
+
+        if (scratch[i].score >= lb[j].score)
+        {
+            lb[k++] = move(scratch[i++]);
+            leftWins++;
+            rightWins = 0;
+        }
+        else
+        {
+            lb[k++] = move(lb[j++]);
+            rightWins++;
+            leftWins = 0;
+        }
+    }
+    // Leftover right elements are already in place
+    while (i < n1)
+        lb[k++] = move(scratch[i++]);
+}
+
+// Minimum run length: n / 2^k in [32, 64], rounded up if any shifted-out bit was set.
+int timMinRun(int n)
+{
+    int r = 0;
+    while (n >= 64)
+    {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+// TimSort-style merge sort (descending by score, stable). Detects natural runs
+// (strictly ascending ones are reversed), extends short runs with binary insertion,
+// and merges a balanced run stack bottom-up through one preallocated scratch buffer.
+// Nearly sorted leaderboards sort in close to O(n).
+template <typename T>
+void timSort(vector<T> &lb)
+{
+    int n = lb.size();
+    if (n < 2)
+        return;
+
+    vector<T> scratch; // allocated once, on the first merge
+    int minRun = timMinRun(n);
+    vector<pair<int, int>> runs; // (start, length)
+
+    auto mergeAt = [&](int r)
+    {
+        if (scratch.empty())
+            scratch.resize(n);
+        int start = runs[r].first, mid = start + runs[r].second, end = mid + runs[r + 1].second;
+        timMerge(lb, scratch, start, mid, end);
+        runs[r].second += runs[r + 1].second;
+        runs.erase(runs.begin() + r + 1);
+    };
+
+    for (int lo = 0; lo < n;)
+    {
+        int hi = lo + 1;
+        if (hi < n)
+        {
+            if (lb[hi].score > lb[lo].score)
+            {
+                while (hi + 1 < n && lb[hi + 1].score > lb[hi].score)
+                    hi++;
+                reverse(lb.begin() + lo, lb.begin() + hi + 1);
+            }
+            else
+            {
+                while (hi + 1 < n && lb[hi + 1].score <= lb[hi].score)
+                    hi++;
+            }
+            hi++;
+        }
+
+        int forced = min(n, lo + minRun);
+        if (hi < forced)
+        {
+            binaryInsertionSort(lb, lo, hi, forced);
+            hi = forced;
+        }
+        runs.push_back({lo, hi - lo});
+        lo = hi;
+
+        // Keep run lengths balanced (the corrected TimSort invariants)
+        while (runs.size() > 1)
+        {
+            int r = runs.size() - 2;
+            if ((r > 0 && runs[r - 1].second <= runs[r].second + runs[r + 1].second) ||
+                (r > 1 && runs[r - 2].second <= runs[r - 1].second + runs[r].second))
+            {
+                if (runs[r - 1].second < runs[r + 1].second)
+                    r--;
+            }
+            else if (runs[r].second > runs[r + 1].second)
+                break;
+            mergeAt(r);
+        }
+    }
+
+    while (runs.size() > 1)
+    {
+        int r = runs.size() - 2;
+        if (r > 0 && runs[r - 1].second < runs[r + 1].second)
+            r--;
+        mergeAt(r);
+    }
+}
+
+// -------------------- Parallel sorting --------------------
+
+// Thread count for the parallel sorts (0 = one per hardware thread); set with --threads.
+unsigned sortThreads = 0;
+
+// Ranges at or below this size are sorted/merged serially instead of being split further.
+const int PARALLEL_CUTOFF = 1 << 13;
+
+unsigned resolveThreadCount(unsigned threads)
+{
+    return threads ? threads : max(1u, thread::hardware_concurrency());
+}
+
+// Fork-join pool with one task deque per thread. Owners push/pop at the back,
+// idle threads steal from the front of other deques.
+struct WorkStealingPool
+{
+    struct Queue
+    {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<Queue>> queues; // queues[0] belongs to the thread that owns the pool
+    vector<thread> workers;
+    atomic<bool> stopping{false};
+    atomic<int> queued{0};
+    mutex sleepLock;
+    condition_variable wake;
+
+    static thread_local size_t self; // index of the current thread's deque
+
+    explicit WorkStealingPool(unsigned threads)
+    {
+        threads = resolveThreadCount(threads);
+        for (unsigned i = 0; i < threads; i++)
+            queues.push_back(make_unique<Queue>());
+        for (unsigned i = 1; i < threads; i++)
+            workers.emplace_back([this, i]
+                                 { workerLoop(i); });
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            lock_guard<mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &w : workers)
+            w.join();
+    }
+
+    void submit(function<void()> task)
+    {
+        Queue &q = *queues[self < queues.size() ? self : 0];
+        {
+            lock_guard<mutex> guard(q.lock);
+            q.tasks.push_back(move(task));
+        }
+        {
+            lock_guard<mutex> guard(sleepLock);
+            queued++;
+        }
+        wake.notify_one();
+    }
+
+    // Run one task from our own deque or stolen from another; false if none was found.
+    bool runOne()
+    {
+        size_t n = queues.size(), me = self < n ? self : 0;
+        function<void()> task;
+        for (size_t k = 0; k < n && !task; k++)
+        {
+            Queue &q = *queues[(me + k) % n];
+            lock_guard<mutex> guard(q.lock);
+            if (q.tasks.empty())
+                continue;
+            if (k == 0)
+            {
+                task = move(q.tasks.back());
+                q.tasks.pop_back();
+            }
+            else
+            {
+                task = move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+        }
+        if (!task)
+            return false;
+        queued--;
+        task();
+        return true;
+    }
+
+    void workerLoop(size_t id)
+    {
+        self = id;
+        while (!stopping)
+        {
+            if (runOne())
+                continue;
+            unique_lock<mutex> lk(sleepLock);
+            wake.wait(lk, [this]
+                      { return stopping || queued > 0; });
+        }
+    }
+};
+
+thread_local size_t WorkStealingPool::self = 0;
+
+// Run task on the pool and count it in pending until it finishes.
+void spawnTask(WorkStealingPool &pool, atomic<int> &pending, function<void()> task)
+{
+    pending++;
+    pool.submit([&pending, task = move(task)]
+                {
+                    task();
+                    pending--; });
+}
+
+// Wait for pending to reach zero, running queued tasks meanwhile so waiting never deadlocks.
+void waitForTasks(WorkStealingPool &pool, atomic<int> &pending)
+{
+    while (pending > 0)
+    {
+        if (!pool.runOne())
+            this_thread::yield();
+    }
+}
+
+// Stable descending merge of src[a1, a2) and src[b1, b2) into dst[d...], split across the pool.
+template <typename T>
+void parallelMerge(WorkStealingPool &pool, vector<T> &src, int a1, int a2, int b1, int b2, vector<T> &dst, int d)
+{
+    int n1 = a2 - a1, n2 = b2 - b1;
+    if (n1 + n2 <= PARALLEL_CUTOFF)
+    {
+        while (a1 < a2 && b1 < b2)
+        {
+            if (src[a1].score >= src[b1].score)
+                dst[d++] = move(src[a1++]);
+            else
+                dst[d++] = move(src[b1++]);
+        }
+        while (a1 < a2)
+            dst[d++] = move(src[a1++]);
+        while (b1 < b2)
+            dst[d++] = move(src[b1++]);
+        return;
+    }
+
+    // Split the larger run at its midpoint and the other run where that key would go.
+    // Left elements win ties, which keeps the merge stable.
+    int i, j;
+    if (n1 >= n2)
+    {
+        i = a1 + n1 / 2;
+        int key = src[i].score;
+        j = partition_point(src.begin() + b1, src.begin() + b2, [key](const T &p)
+                            { return p.score > key; }) - src.begin();
+    }
+    else
+    {
+        j = b1 + n2 / 2;
+        int key = src[j].score;
+        i = partition_point(src.begin() + a1, src.begin() + a2, [key](const T &p)
+                            { return p.score >= key; }) - src.begin();
+    }
+
+    atomic<int> pending{0};
+    spawnTask(pool, pending, [&, a1, i, b1, j, d]
+              { parallelMerge(pool, src, a1, i, b1, j, dst, d); });
+    parallelMerge(pool, src, i, a2, j, b2, dst, d + (i - a1) + (j - b1));
+    waitForTasks(pool, pending);
+}
+
+// Sort a[lo, hi); the result ends up in b if intoB is set, otherwise in a.
+template <typename T>
+void parallelMergeSortRange(WorkStealingPool &pool, vector<T> &a, vector<T> &b, int lo, int hi, bool intoB)
+{
+    if (hi - lo <= PARALLEL_CUTOFF)
+    {
+        mergeSort(a, lo, hi - 1);
+        if (intoB)
+            move(a.begin() + lo, a.begin() + hi, b.begin() + lo);
+        return;
+    }
+
+    // Sort both halves into the other buffer, then merge back (ping-pong, no copy-back pass)
+    int mid = lo + (hi - lo) / 2;
+    atomic<int> pending{0};
+    spawnTask(pool, pending, [&, lo, mid, intoB]
+              { parallelMergeSortRange(pool, a, b, lo, mid, !intoB); });
+    parallelMergeSortRange(pool, a, b, mid, hi, !intoB);
+    waitForTasks(pool, pending);
+
+    if (intoB)
+        parallelMerge(pool, a, lo, mid, mid, hi, b, lo);
+    else
+        parallelMerge(pool, b, lo, mid, mid, hi, a, lo);
+}
+
+// Parallel merge sort (descending by score, stable).
+template <typename T>
+void parallelMergeSort(vector<T> &lb, unsigned threads)
+{
+    if (lb.size() < 2)
+        return;
+    WorkStealingPool pool(threads);
+    vector<T> scratch(lb.size());
+    parallelMergeSortRange(pool, lb, scratch, 0, lb.size(), false);
+}
+
+// Quick sort lb[low, high] with the left side of each partition handed to the pool.
+// Partitions three ways like introSort, so duplicate scores collapse into one middle
+// block, and switches to heap sort past depthLimit.
+template <typename T>
+void parallelQuickSortRange(WorkStealingPool &pool, vector<T> &lb, int low, int high, int depthLimit,
+                            atomic<int> &pending)
+{
+    while (high - low + 1 > PARALLEL_CUTOFF)
+    {
+        if (depthLimit-- == 0)
+        {
+            heapSortRange(lb, low, high);
+            return;
+        }
+
+        int lt, gt;
+        partitionThreeWay(lb, low, high, lt, gt);
+        spawnTask(pool, pending, [&pool, &lb, &pending, low, lt, depthLimit]
+                  { parallelQuickSortRange(pool, lb, low, lt - 1, depthLimit, pending); });
+        low = gt + 1;
+    }
+    introSortRange(lb, low, high, depthLimit);
+}
+
+// Parallel quick sort (descending by score).
+template <typename T>
+void parallelQuickSort(vector<T> &lb, unsigned threads)
+{
+    WorkStealingPool pool(threads);
+    atomic<int> pending{0};
+    int depthLimit = 0;
+    for (size_t n = lb.size(); n > 1; n >>= 1)
+        depthLimit += 2;
+    parallelQuickSortRange(pool, lb, 0, int(lb.size()) - 1, depthLimit, pending);
+    waitForTasks(pool, pending);
+}
+
+// -------------------- Key/index sorting --------------------
+
+// Set with --key-sort: option 2 sorts SortKeys and materialises Players only for display.
+bool keySortMode = false;
+
+// Compact sort record: a score plus the player's slot in the leaderboard.
+// Kernels move 8 bytes per element instead of a Player and its std::string.
+struct SortKey
+{
+    int score;
+    uint32_t index;
+};
+
+vector<SortKey> makeSortKeys(const vector<Player> &lb)
+{
+    vector<SortKey> keys(lb.size());
+    for (size_t i = 0; i < lb.size(); i++)
+        keys[i] = {lb[i].score, uint32_t(i)};
+    return keys;
+}
+
+// Build the Player order described by sorted keys.
+vector<Player> materializeOrder(const vector<Player> &lb, const vector<SortKey> &keys)
+{
+    vector<Player> out;
+    out.reserve(keys.size());
+    for (const auto &k : keys)
+        out.push_back(lb[k.index]);
+    return out;
+}
+
+// -------------------- Adaptive sort dispatcher --------------------
+
+// Input statistics and the algorithm Auto picked from them.
+struct AutoDecision
+{
+    size_t n = 0;
+    int64_t range = 0;        // max - min + 1
+    double duplicateRatio = 0; // share of sampled scores that repeat
+    double ascentRatio = 0;    // share of adjacent pairs out of leaderboard order
+    int algo = 0;              // menu algorithm number
+    string chosen;             // its name, filled in once it has run
+    string reason;
+    double decisionMs = 0;
+};
+
+// Most recent decision, printed by menu option 2.
+AutoDecision lastAutoDecision;
+
+// Counting sort buckets Auto may allocate: never more than a few ints per player.
+const int64_t AUTO_COUNTING_MAX_RANGE = 1 << 24;
+
+// Sampled duplicate share above which a wide score range goes to the three-way introsort:
+// with only a handful of distinct scores it finishes in a few partition passes, about
+// twice as fast as four radix passes on 1M players.
+const double AUTO_FEW_DISTINCT_RATIO = 0.97;
+
+// Sample the input once (size, score range, duplicate ratio, presortedness) and pick
+// the algorithm that should be fastest without risking a huge allocation.
+template <typename T>
+AutoDecision chooseSortAlgorithm(const vector<T> &arr)
+{
+    auto start = chrono::high_resolution_clock::now();
+    AutoDecision d;
+    d.n = arr.size();
+    if (d.n < 2)
+    {
+        d.algo = 2;
+        d.reason = "trivial input";
+        return d;
+    }
+
+    // One pass: range and adjacent out-of-order pairs
+    int minScore = arr[0].score, maxScore = arr[0].score;
+    size_t ascents = 0;
+    for (size_t i = 1; i < d.n; i++)
+    {
+        minScore = min(minScore, arr[i].score);
+        maxScore = max(maxScore, arr[i].score);
+        ascents += arr[i].score > arr[i - 1].score;
+    }
+    d.range = int64_t(maxScore) - minScore + 1;
+    d.ascentRatio = double(ascents) / (d.n - 1);
+
+    // Duplicate ratio from an evenly spaced sample of up to 256 scores
+    size_t sampleSize = min<size_t>(d.n, 256);
+    vector<int> sample(sampleSize);
+    for (size_t i = 0; i < sampleSize; i++)
+        sample[i] = arr[i * d.n / sampleSize].score;
+    sort(sample.begin(), sample.end());
+    size_t distinct = unique(sample.begin(), sample.end()) - sample.begin();
+    d.duplicateRatio = 1.0 - double(distinct) / sampleSize;
+
+    if (d.n <= 32)
+    {
+        d.algo = 2;
+        d.reason = "tiny input: insertion sort";
+    }
+    else if (d.ascentRatio < 0.02 || d.ascentRatio > 0.98)
+    {
+        d.algo = 12;
+        d.reason = "nearly sorted or reversed: natural runs";
+    }
+    else if (d.range <= AUTO_COUNTING_MAX_RANGE && d.range <= 8 * int64_t(d.n))
+    {
+        d.algo = 7;
+        d.reason = "dense score range: counting buckets <= 8n";
+    }
+    else if (d.duplicateRatio > AUTO_FEW_DISTINCT_RATIO)
+    {
+        d.algo = 11;
+        d.reason = "few distinct scores over a wide range: three-way introsort";
+    }
+    else if (d.n >= 2048)
+    {
+        d.algo = 10;
+        d.reason = "large input, wide range: byte-wise radix";
+    }
+    else
+    {
+        d.algo = 11;
+        d.reason = "small input: introsort";
+    }
+    d.decisionMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+    return d;
+}
+
+// Log line for an Auto decision.
+string describeAutoDecision(const AutoDecision &d)
+{
+    ostringstream out;
+    out << "Auto: n=" << d.n << ", range=" << d.range << ", duplicates=" << fixed << setprecision(2)
+        << d.duplicateRatio * 100 << "%, out-of-order pairs=" << d.ascentRatio * 100 << "% -> " << d.chosen
+        << " (" << d.reason << "; decided in " << setprecision(3) << d.decisionMs << " ms)";
+    return out.str();
+}
+
+// Number of algorithms selectable in menu option 2.
+const int SORT_ALGORITHM_COUNT = 13;
+
+// Run menu algorithm number algo on arr (Players or SortKeys); false if the number is invalid.
+template <typename T>
+bool runSortAlgorithm(int algo, vector<T> &arr, string &algoName)
+{
+    switch (algo)
+    {
+    case 1:
+        algoName = "Bubble Sort";
+        bubbleSort(arr);
+        break;
+    case 2:
+        algoName = "Insertion Sort";
+        insertionSort(arr);
+        break;
+    case 3:
+        algoName = "Selection Sort";
+        selectionSort(arr);
+        break;
+    case 4:
+        algoName = "Merge Sort";
+        mergeSort(arr, 0, arr.size() - 1);
+        break;
+    case 5:
+        algoName = "Quick Sort";
+        quickSort(arr, 0, arr.size() - 1);
+        break;
+    case 6:
+        algoName = "Heap Sort";
+        heapSort(arr);
+        break;
+    case 7:
+        algoName = "Counting Sort";
+        countingSort(arr);
+        break;
+    case 8:
+        algoName = "Parallel Merge Sort";
+        parallelMergeSort(arr, sortThreads);
+        break;
+    case 9:
+        algoName = "Parallel Quick Sort";
+        parallelQuickSort(arr, sortThreads);
+        break;
+    case 10:
+        algoName = "Radix Sort";
+        radixSort(arr);
+        break;
+    case 11:
+        algoName = "Intro Sort";
+        introSort(arr);
+        break;
+    case 12:
+        algoName = "Tim Sort";
+        timSort(arr);
+        break;
+    case 13:
+    {
+        lastAutoDecision = chooseSortAlgorithm(arr);
+        runSortAlgorithm(lastAutoDecision.algo, arr, lastAutoDecision.chosen);
+        algoName = "Auto";
+        break;
+    }
+    default:
+        return false;
+    }
+    return true;
+}
+
+// -------------------- Searching --------------------
+
+// Linear search by exact name.
+int linearSearch(const vector<Player> &leaderboard, const string &name)
+{
+    for (int i = 0; i < leaderboard.size(); i++)
+    {
+        if (nameOf(leaderboard[i]) == name)
+            return i;
+    }
+    return -1; // not found
+}
+
+// Binary search on sorted-by-name vector.
+int binarySearch(const vector<Player> &leaderboard, const string &name)
+{
+    int low = 0, high = leaderboard.size() - 1;
+
+    while (low <= high)
+    {
+        int mid = low + (high - low) / 2;
+
+        string_view midName = nameOf(leaderboard[mid]);
+        if (midName == name)
+            return mid;
+        else if (midName < name)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return -1; // not found
+}
+
+// -------------------- Utilities --------------------
+
+// Create a unique name if duplicate exists (adds " (n)").
+// O(n) scan kept for comparison; the menu uses uniqueName() with the suffix map.
+string generateUniqueName(const string &name, const vector<Player> &lb)
+{
+    int count = 0;
+    for (const auto &p : lb)
+    {
+        string_view pName = nameOf(p);
+        if (pName == name || pName.find(name + " (") == 0)
+            count++;
+    }
+    if (count == 0)
+        return name;
+    else
+        return name + " (" + to_string(count) + ")";
+}
+
+// Return complexity description for display.
+string getComplexityInfo(const string &algo)
+{
+    if (algo == "Bubble Sort")
+        return "Time: O(n^2), Space: O(1)";
+    if (algo == "Insertion Sort")
+        return "Time: O(n^2), Space: O(1)";
+    if (algo == "Selection Sort")
+        return "Time: O(n^2), Space: O(1)";
+    if (algo == "Merge Sort")
+        return "Time: O(n log n), Space: O(n)";
+    if (algo == "Quick Sort")
+        return "Time: O(n log n) , O(n^2) , Space: O(log n)";
+    if (algo == "Heap Sort")
+        return "Time: O(n log n), Space: O(1)";
+    if (algo == "Counting Sort")
+        return "Time: O(n + k), Space: O(n + k)";
+    if (algo == "Radix Sort")
+        return "Time: O(4n), Space: O(n)";
+    if (algo == "Intro Sort")
+        return "Time: O(n log n) worst, Space: O(log n)";
+    if (algo == "Tim Sort")
+        return "Time: O(n) presorted, O(n log n) worst, Space: O(n)";
+    if (algo == "Auto")
+        return "Time: best of O(n) / O(n + k) / O(n log n) for the input, Space: O(n)";
+    if (algo == "Parallel Merge Sort")
+        return "Time: O(n log n / p), Space: O(n)";
+    if (algo == "Parallel Quick Sort")
+        return "Time: O(n log n / p) avg, Space: O(log n)";
+    return "Unknown Complexity";
+}
+
+// Parse a numeric command-line value for flag; prints a usage error and returns false if it isn't one.
+template <typename T>
+bool parseArg(const char *flag, string_view text, T &value)
+{
+    T parsed{};
+    auto [end, ec] = from_chars(text.data(), text.data() + text.size(), parsed);
+    if (text.empty() || ec != errc() || end != text.data() + text.size())
+    {
+        cout << "Invalid value for " << flag << ": '" << text << "' (expected a number)\n";
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// -------------------- Bulk ingestion --------------------
+
+// Add every "name,score" row from in to the leaderboard in one batch:
+// names are deduplicated in a single pass, players.csv gets one buffered append,
+// and at most one history snapshot is taken for the whole batch.
+void bulkIngest(istream &in, vector<Player> &leaderboard, LeaderboardIndex &index, const string &filename = "players.csv")
+{
+    auto start = chrono::high_resolution_clock::now();
+
+    string input(istreambuf_iterator<char>(in), {});
+    vector<Player> batch;
+    parsePlayerChunk(input.data(), input.data() + input.size(), batch, playerNames);
+    if (batch.empty())
+    {
+        cout << "No rows to ingest.\n";
+        return;
+    }
+
+    // Single pass: rename duplicates through the suffix map, index, and buffer the CSV rows
+    int renamed = 0;
+    string rows;
+    rows.reserve(input.size() + batch.size() * 4);
+    leaderboard.reserve(leaderboard.size() + batch.size());
+    for (auto &p : batch)
+    {
+        string_view original = nameOf(p);
+        string name = uniqueName(index, original);
+        if (name != original)
+        {
+            p.name = internName(name);
+            renamed++;
+        }
+        leaderboard.push_back(p);
+        indexPlayer(index, leaderboard, leaderboard.size() - 1);
+        rows += name;
+        rows += ',';
+        rows += to_string(p.score);
+        rows += '\n';
+    }
+
+    // One queued append; the writer starts it on a fresh line if the file lacks a trailing newline
+    PersistWriter::Job job;
+    job.kind = PersistWriter::Job::Append;
+    job.path = filename;
+    job.bytes = move(rows);
+    job.records = batch.size();
+    job.freshLine = true;
+    persistWriter.submit(move(job));
+
+    saveSnapshot(leaderboard, "Bulk Ingest");
+
+    auto end = chrono::high_resolution_clock::now();
+    double seconds = chrono::duration<double>(end - start).count();
+    cout << "Ingested " << batch.size() << " players (" << renamed << " renamed) in " << fixed
+         << setprecision(3) << seconds * 1000 << " ms (" << setprecision(0)
+         << batch.size() / max(seconds, 1e-9) << " rows/s).\n";
+}
+
+// -------------------- Concurrent ingestion --------------------
+
+// Bounded lock-free queue for many producers and one consumer (Vyukov's ring): each
+// cell carries a sequence number, producers claim a position with one CAS and publish
+// the cell by bumping its sequence; the consumer needs no atomic read-modify-write.
+template <typename T>
+struct MpscQueue
+{
+    struct Cell
+    {
+        atomic<size_t> sequence;
+        T value;
+    };
+
+    vector<Cell> cells;
+    size_t mask;
+    alignas(64) atomic<size_t> enqueuePos{0};
+    alignas(64) size_t dequeuePos = 0;
+
+    explicit MpscQueue(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        cells = vector<Cell>(size);
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++)
+            cells[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    // Any thread; false if the queue is full.
+    bool tryPush(T &value)
+    {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        Cell *cell;
+        while (true)
+        {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(memory_order_acquire);
+            intptr_t diff = intptr_t(seq) - intptr_t(pos);
+            if (diff == 0 && enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                break;
+            if (diff < 0)
+                return false;
+            if (diff > 0)
+                pos = enqueuePos.load(memory_order_relaxed);
+        }
+        cell->value = move(value);
+        cell->sequence.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only: move up to max ready items into out; returns how many.
+    size_t popBatch(vector<T> &out, size_t max)
+    {
+        size_t n = 0;
+        for (; n < max; n++)
+        {
+            Cell &cell = cells[dequeuePos & mask];
+            if (cell.sequence.load(memory_order_acquire) != dequeuePos + 1)
+                break;
+            out.push_back(move(cell.value));
+            cell.sequence.store(dequeuePos + mask + 1, memory_order_release);
+            dequeuePos++;
+        }
+        return n;
+    }
+};
+
+struct ScoreSubmission
+{
+    string name;
+    int score;
+};
+
+// Largest batch the applier drains and applies at once.
+const size_t INGEST_BATCH = 4096;
+
+// Parse one "name,score" line (name may contain commas); false for malformed rows.
+bool parseSubmissionLine(string_view line, ScoreSubmission &out)
+{
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    size_t comma = line.rfind(',');
+    if (comma == string_view::npos || comma == 0 || comma > MAX_NAME_BYTES)
+        return false;
+    auto r = from_chars(line.data() + comma + 1, line.data() + line.size(), out.score);
+    if (r.ec != errc())
+        return false;
+    out.name.assign(line.data(), comma);
+    return true;
+}
+
+// Apply one drained batch: unique names, leaderboard and indexes, windowed boards, and one
+// queued append per file for the whole batch.
+void applySubmissions(vector<ScoreSubmission> &batch, vector<Player> &leaderboard, LeaderboardIndex &index,
+                      WindowedBoards *windows, const string &filename)
+{
+    int64_t now = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+    string rows, submissions;
+    for (auto &s : batch)
+    {
+        string name = uniqueName(index, s.name);
+        leaderboard.push_back({internName(name), s.score});
+        indexPlayer(index, leaderboard, leaderboard.size() - 1);
+        rows += name + ',' + to_string(s.score) + '\n';
+        if (windows)
+        {
+            windowedSubmit(*windows, name, s.score, now);
+            submissions += name + ',' + to_string(s.score) + ',' + to_string(now) + '\n';
+        }
+    }
+
+    PersistWriter::Job job;
+    job.kind = PersistWriter::Job::Append;
+    job.path = filename;
+    job.bytes = move(rows);
+    job.records = batch.size();
+    job.freshLine = true;
+    persistWriter.submit(job);
+    if (windows)
+    {
+        job.path = SUBMISSIONS_FILE;
+        job.bytes = move(submissions);
+        persistWriter.submit(move(job));
+    }
+}
+
+struct IngestResult
+{
+    size_t applied = 0, batches = 0;
+    double seconds = 0;
+    vector<double> enqueueNs; // per-push latency samples (when requested)
+};
+
+// Run each producer on its own thread, pushing into a shared MpscQueue, while one applier
+// thread drains it in batches of up to INGEST_BATCH into the leaderboard. A producer
+// calls push(submission) for every row; push spins (yielding) while the queue is full.
+IngestResult concurrentIngest(const vector<function<void(const function<void(ScoreSubmission &)> &)>> &producers,
+                              vector<Player> &leaderboard, LeaderboardIndex &index, WindowedBoards *windows,
+                              const string &filename = "players.csv", bool sampleLatency = false)
+{
+    MpscQueue<ScoreSubmission> queue(1 << 16);
+    atomic<size_t> running{producers.size()};
+    IngestResult result;
+    vector<vector<double>> samples(producers.size());
+
+    auto start = chrono::steady_clock::now();
+    thread applier([&]
+                   {
+        vector<ScoreSubmission> batch;
+        batch.reserve(INGEST_BATCH);
+        while (true)
+        {
+            bool finished = running.load(memory_order_acquire) == 0;
+            if (queue.popBatch(batch, INGEST_BATCH) == 0)
+            {
+                if (finished)
+                    break; // every producer is done and the queue was empty after that
+                this_thread::yield();
+                continue;
+            }
+            applySubmissions(batch, leaderboard, index, windows, filename);
+            result.applied += batch.size();
+            result.batches++;
+            batch.clear();
+        } });
+
+    vector<thread> threads;
+    for (size_t p = 0; p < producers.size(); p++)
+        threads.emplace_back([&, p]
+                             {
+            auto push = [&](ScoreSubmission &s)
+            {
+                auto t0 = chrono::steady_clock::now();
+                while (!queue.tryPush(s))
+                    this_thread::yield();
+                if (sampleLatency)
+                    samples[p].push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count());
+            };
+            producers[p](push);
+            running.fetch_sub(1, memory_order_release); });
+    for (auto &t : threads)
+        t.join();
+    applier.join();
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    for (auto &s : samples)
+        result.enqueueNs.insert(result.enqueueNs.end(), s.begin(), s.end());
+    return result;
+}
+
+// One producer per file, each streaming its "name,score" rows into the ingest queue.
+void ingestFilesConcurrently(const vector<string> &files, vector<Player> &leaderboard, LeaderboardIndex &index,
+                             WindowedBoards *windows, const string &filename = "players.csv")
+{
+    vector<function<void(const function<void(ScoreSubmission &)> &)>> producers;
+    for (const auto &path : files)
+        producers.push_back([path](const function<void(ScoreSubmission &)> &push)
+                            {
+            ifstream in(path, ios::binary);
+            if (!in.is_open())
+            {
+                cout << "Could not open " << path << ".\n";
+                return;
+            }
+            string line;
+            ScoreSubmission s;
+            while (getline(in, line))
+                if (parseSubmissionLine(line, s))
+                    push(s); });
+
+    IngestResult r = concurrentIngest(producers, leaderboard, index, windows, filename);
+    if (r.applied)
+        saveSnapshot(leaderboard, "Concurrent Ingest");
+    cout << "Ingested " << r.applied << " players from " << files.size() << " producer(s) in " << r.batches
+         << " batches, " << fixed << setprecision(3) << r.seconds * 1000 << " ms (" << setprecision(0)
+         << r.applied / max(r.seconds, 1e-9) << " rows/s).\n";
+}
+
+// -------------------- Multi-board engine --------------------
+
+// Hosts many named leaderboards (e.g. one per game mode and region) in one process.
+// Boards are spread over shards by a hash of their name, and writers lock only their
+// shard. Each board is published as an immutable, rank-sorted BoardSnapshot, and each
+// shard's board directory is immutable too; both are replaced with a single atomic
+// store. Readers never lock or wait: they announce the current epoch, read through the
+// published pointers and leave. A replaced snapshot is freed only once every reader that
+// could still hold it has left (epoch-based reclamation).
+
+// Immutable board contents in rank order (score desc, then name), names packed in one blob.
+struct BoardSnapshot
+{
+    vector<int> scores;
+    vector<uint32_t> nameEnds; // end offset of each rank's name in names
+    string names;
+    vector<uint32_t> byName; // ranks ordered by name, for rank-of lookups
+
+    size_t size() const
+    {
+        return scores.size();
+    }
+
+    string_view nameAt(size_t rank) const
+    {
+        uint32_t begin = rank ? nameEnds[rank - 1] : 0;
+        return string_view(names).substr(begin, nameEnds[rank] - begin);
+    }
+
+    // 0-based rank of the player in O(log n), or -1.
+    long long find(string_view name) const
+    {
+        auto it = lower_bound(byName.begin(), byName.end(), name, [this](uint32_t r, string_view n)
+                              { return nameAt(r) < n; });
+        return it != byName.end() && nameAt(*it) == name ? (long long)*it : -1;
+    }
+};
+
+// Reader slots available to concurrently reading threads.
+const int EPOCH_READER_SLOTS = 256;
+
+struct EpochDomain
+{
+    struct alignas(64) Slot
+    {
+        atomic<uint64_t> epoch{0}; // epoch the reader entered in, 0 = not reading
+        atomic<bool> claimed{false};
+    };
+
+    atomic<uint64_t> global{1};
+    Slot slots[EPOCH_READER_SLOTS];
+    mutex retireLock; // writers only
+    vector<pair<uint64_t, function<void()>>> retired;
+
+    ~EpochDomain()
+    {
+        for (auto &r : retired)
+            r.second();
+    }
+};
+
+EpochDomain epochs;
+
+// Reader slot owned by the calling thread, released when the thread exits.
+EpochDomain::Slot &epochSlot()
+{
+    struct Handle
+    {
+        int index = -1;
+        ~Handle()
+        {
+            if (index >= 0)
+                epochs.slots[index].claimed.store(false, memory_order_release);
+        }
+    };
+    thread_local Handle handle;
+    while (handle.index < 0)
+    {
+        for (int i = 0; i < EPOCH_READER_SLOTS && handle.index < 0; i++)
+        {
+            bool expected = false;
+            if (epochs.slots[i].claimed.compare_exchange_strong(expected, true))
+                handle.index = i;
+        }
+        if (handle.index < 0)
+            this_thread::yield(); // more live readers than slots: wait for one to exit
+    }
+    return epochs.slots[handle.index];
+}
+
+// Marks the calling thread as reading for its lifetime; published pointers loaded inside
+// stay valid until it is destroyed.
+struct EpochGuard
+{
+    EpochDomain::Slot &slot;
+
+    EpochGuard() : slot(epochSlot())
+    {
+        slot.epoch.store(epochs.global.load());
+    }
+
+    ~EpochGuard()
+    {
+        slot.epoch.store(0, memory_order_release);
+    }
+};
+
+// Free retired objects that no active reader can still see (caller holds retireLock).
+void reclaimRetired()
+{
+    uint64_t oldest = UINT64_MAX;
+    for (auto &s : epochs.slots)
+    {
+        uint64_t e = s.epoch.load();
+        if (e != 0)
+            oldest = min(oldest, e);
+    }
+    auto keep = partition(epochs.retired.begin(), epochs.retired.end(), [oldest](const auto &r)
+                          { return r.first >= oldest; });
+    for (auto it = keep; it != epochs.retired.end(); ++it)
+        it->second();
+    epochs.retired.erase(keep, epochs.retired.end());
+}
+
+// Hand an object that was just unpublished to the reclaimer.
+template <typename T>
+void retire(const T *object)
+{
+    if (!object)
+        return;
+    uint64_t epoch = epochs.global.fetch_add(1);
+    lock_guard<mutex> guard(epochs.retireLock);
+    epochs.retired.push_back({epoch, [object]
+                              { delete object; }});
+    reclaimRetired();
+}
+
+struct EngineBoard
+{
+    string name;
+    atomic<const BoardSnapshot *> snapshot{nullptr};
+    uint64_t publishes = 0; // writer side, under the shard lock
+};
+
+struct BoardDirectory
+{
+    unordered_map<string, EngineBoard *> boards;
+};
+
+struct EngineShard
+{
+    mutex writeLock;
+    vector<unique_ptr<EngineBoard>> boards;
+    atomic<const BoardDirectory *> directory{new BoardDirectory()};
+};
+
+struct LeaderboardEngine
+{
+    vector<unique_ptr<EngineShard>> shards;
+
+    explicit LeaderboardEngine(size_t shardCount = 16)
+    {
+        for (size_t i = 0; i < max<size_t>(shardCount, 1); i++)
+            shards.push_back(make_unique<EngineShard>());
+    }
+
+    // Callers make sure no reader or writer is still running.
+    ~LeaderboardEngine()
+    {
+        for (auto &shard : shards)
+        {
+            for (auto &board : shard->boards)
+                delete board->snapshot.load();
+            delete shard->directory.load();
+        }
+    }
+};
+
+EngineShard &shardFor(const LeaderboardEngine &engine, string_view board)
+{
+    return *engine.shards[hashName(board) % engine.shards.size()];
+}
+
+// New snapshot = old snapshot with the batch applied (each player keeps their best score).
+// Runs in O(n + k log k): unchanged rows and the name order are merged, never re-sorted.
+BoardSnapshot *buildBoardSnapshot(const BoardSnapshot *old, vector<pair<string, int>> &batch)
+{
+    static const BoardSnapshot empty;
+    if (!old)
+        old = &empty;
+
+    // Best score per name in the batch, kept only if it improves on the published one
+    sort(batch.begin(), batch.end(), [](const auto &a, const auto &b)
+         { return a.first != b.first ? a.first < b.first : a.second > b.second; });
+    vector<pair<string, int>> changes; // in name order
+    vector<bool> replaced(old->size(), false);
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        if (i > 0 && batch[i].first == batch[i - 1].first)
+            continue; // lower score for a name already seen
+        long long rank = old->find(batch[i].first);
+        if (rank >= 0 && old->scores[rank] >= batch[i].second)
+            continue;
+        if (rank >= 0)
+            replaced[rank] = true;
+        changes.push_back(batch[i]);
+    }
+    if (changes.empty())
+        return nullptr;
+
+    vector<uint32_t> changeOrder(changes.size()); // changes by rank
+    for (size_t i = 0; i < changes.size(); i++)
+        changeOrder[i] = i;
+    sort(changeOrder.begin(), changeOrder.end(), [&](uint32_t a, uint32_t b)
+         { return changes[a].second != changes[b].second ? changes[a].second > changes[b].second : a < b; });
+
+    // Merge unchanged rows with the changes by rank
+    auto *next = new BoardSnapshot();
+    size_t total = old->size() + changes.size();
+    next->scores.reserve(total);
+    next->nameEnds.reserve(total);
+    next->names.reserve(old->names.size() + changes.size() * 16);
+    vector<uint32_t> oldToNew(old->size()), changeToNew(changes.size());
+    auto append = [&](string_view name, int score)
+    {
+        next->names += name;
+        next->scores.push_back(score);
+        next->nameEnds.push_back(next->names.size());
+        return uint32_t(next->scores.size() - 1);
+    };
+    size_t o = 0, c = 0;
+    while (o < old->size() || c < changes.size())
+    {
+        if (o < old->size() && replaced[o])
+        {
+            o++;
+            continue;
+        }
+        bool takeOld = c == changes.size();
+        if (!takeOld && o < old->size())
+        {
+            const auto &ch = changes[changeOrder[c]];
+            takeOld = old->scores[o] != ch.second ? old->scores[o] > ch.second : old->nameAt(o) < ch.first;
+        }
+        if (takeOld)
+        {
+            oldToNew[o] = append(old->nameAt(o), old->scores[o]);
+            o++;
+        }
+        else
+        {
+            changeToNew[changeOrder[c]] = append(changes[changeOrder[c]].first, changes[changeOrder[c]].second);
+            c++;
+        }
+    }
+
+    // Merge the name order the same way
+    next->byName.reserve(next->size());
+    size_t b = 0;
+    c = 0;
+    while (b < old->byName.size() || c < changes.size())
+    {
+        if (b < old->byName.size() && replaced[old->byName[b]])
+        {
+            b++;
+            continue;
+        }
+        if (c == changes.size() || (b < old->byName.size() && old->nameAt(old->byName[b]) < changes[c].first))
+            next->byName.push_back(oldToNew[old->byName[b++]]);
+        else
+            next->byName.push_back(changeToNew[c++]);
+    }
+    return next;
+}
+
+// Apply (player, score) submissions to a board, creating it on first use, and publish the
+// new snapshot. Blocks only other writers of the same shard.
+void engineSubmit(LeaderboardEngine &engine, const string &boardName, vector<pair<string, int>> batch)
+{
+    EngineShard &shard = shardFor(engine, boardName);
+    lock_guard<mutex> guard(shard.writeLock);
+
+    const BoardDirectory *dir = shard.directory.load(memory_order_acquire);
+    auto it = dir->boards.find(boardName);
+    EngineBoard *board;
+    if (it != dir->boards.end())
+        board = it->second;
+    else
+    {
+        shard.boards.push_back(make_unique<EngineBoard>());
+        board = shard.boards.back().get();
+        board->name = boardName;
+        auto *nextDir = new BoardDirectory(*dir);
+        nextDir->boards[boardName] = board;
+        shard.directory.store(nextDir);
+        retire(dir);
+    }
+
+    const BoardSnapshot *old = board->snapshot.load(memory_order_acquire);
+    BoardSnapshot *next = buildBoardSnapshot(old, batch);
+    if (!next)
+        return;
+    board->snapshot.store(next);
+    board->publishes++;
+    retire(old);
+}
+
+// Published snapshot of a board (nullptr if unknown/empty). Only valid inside an EpochGuard;
+// the sequentially consistent loads pair with the writer's store and epoch bump.
+const BoardSnapshot *engineSnapshot(const LeaderboardEngine &engine, const string &boardName)
+{
+    const BoardDirectory *dir = shardFor(engine, boardName).directory.load();
+    auto it = dir->boards.find(boardName);
+    return it == dir->boards.end() ? nullptr : it->second->snapshot.load();
+}
+
+// Lock-free read: the best n players of a board.
+vector<pair<string, int>> engineTop(const LeaderboardEngine &engine, const string &boardName, size_t n)
+{
+    EpochGuard guard;
+    vector<pair<string, int>> out;
+    if (const BoardSnapshot *snap = engineSnapshot(engine, boardName))
+        for (size_t r = 0; r < min(n, snap->size()); r++)
+            out.push_back({string(snap->nameAt(r)), snap->scores[r]});
+    return out;
+}
+
+// Lock-free read: 1-based rank of a player on a board (0 if absent) and their score.
+size_t engineRankOf(const LeaderboardEngine &engine, const string &boardName, string_view player, int *score = nullptr)
+{
+    EpochGuard guard;
+    const BoardSnapshot *snap = engineSnapshot(engine, boardName);
+    long long rank = snap ? snap->find(player) : -1;
+    if (rank < 0)
+        return 0;
+    if (score)
+        *score = snap->scores[rank];
+    return rank + 1;
+}
+
+// Lock-free read: every board name with its player count.
+vector<pair<string, size_t>> engineBoards(const LeaderboardEngine &engine)
+{
+    EpochGuard guard;
+    vector<pair<string, size_t>> out;
+    for (const auto &shard : engine.shards)
+        for (const auto &b : shard->directory.load()->boards)
+        {
+            const BoardSnapshot *snap = b.second->snapshot.load();
+            out.push_back({b.first, snap ? snap->size() : 0});
+        }
+    sort(out.begin(), out.end());
+    return out;
+}
+
+// -------------------- Socket server --------------------
+
+// Line protocol served by "leaderboard serve" (one request per line, pipelining allowed:
+// responses come back in request order):
+//   ADD <score> <name>  -> OK <rank> <name>      (name made unique, stored like option 1)
+//   SEARCH <name>       -> OK <score> <name>     exact name lookup
+//   RANK <name>         -> OK <rank> <score>
+//   AT <rank>           -> OK <score> <name>
+//   TOP <k>             -> OK <count>, then count lines "<rank> <score> <name>"
+//   PREFIX <text>       -> OK <count>, then up to 10 lines "<score> <name>" in name order
+//   FUZZY <d> <name>    -> OK <count>, then up to 10 lines "<edits> <score> <name>" (d <= 3, name <= 64 bytes)
+//   PING                -> OK PONG
+//   QUIT                -> OK BYE, then the server closes the connection
+// Errors are a single "ERR <reason>" line.
+const string DEFAULT_SERVER_SOCKET = "leaderboard.sock";
+
+// Largest TOP a client may ask for in one request.
+const int SERVER_MAX_TOP = 10000;
+
+// Unsent response bytes at which the server stops reading a connection's requests until
+// the client catches up, so a client that pipelines without reading cannot grow memory.
+const size_t SERVER_MAX_PENDING_OUTPUT = 4 << 20;
+
+// Execute one request line against the leaderboard and append its response to out.
+// Returns false when the client asked to close the connection.
+bool handleServerCommand(string_view line, string &out, vector<Player> &leaderboard, LeaderboardIndex &index,
+                         WindowedBoards &windows)
+{
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    size_t space = line.find(' ');
+    string_view cmd = line.substr(0, space), arg = space == string_view::npos ? string_view() : line.substr(space + 1);
+    auto parseInt = [](string_view text, int &value)
+    {
+        auto r = from_chars(text.data(), text.data() + text.size(), value);
+        return r.ec == errc() && r.ptr == text.data() + text.size();
+    };
+
+    if (cmd == "ADD")
+    {
+        size_t sep = arg.find(' ');
+        int score;
+        if (sep == string_view::npos || sep + 1 == arg.size() || !parseInt(arg.substr(0, sep), score))
+        {
+            out += "ERR usage: ADD <score> <name>\n";
+            return true;
+        }
+        if (arg.size() - sep - 1 > MAX_NAME_BYTES)
+        {
+            out += "ERR name too long\n";
+            return true;
+        }
+        string name = uniqueName(index, arg.substr(sep + 1));
+        leaderboard.push_back({internName(name), score});
+        indexPlayer(index, leaderboard, leaderboard.size() - 1);
+        appendPlayerToCSV(leaderboard.back());
+        recordSubmission(windows, name, score);
+        out += "OK " + to_string(rankOf(index.rank, leaderboard, leaderboard.size() - 1)) + ' ' + name + '\n';
+    }
+    else if (cmd == "SEARCH" || cmd == "RANK")
+    {
+        int slot = nameLookup(index.names, arg);
+        if (slot == -1)
+            out += "ERR not found\n";
+        else if (cmd == "SEARCH")
+            out += "OK " + to_string(leaderboard[slot].score) + ' ' + string(arg) + '\n';
+        else
+            out += "OK " + to_string(rankOf(index.rank, leaderboard, slot)) + ' ' + to_string(leaderboard[slot].score) + '\n';
+    }
+    else if (cmd == "AT")
+    {
+        int rank, slot;
+        if (!parseInt(arg, rank) || (slot = playerAtRank(index.rank, rank)) == -1)
+            out += "ERR no such rank\n";
+        else
+            out += "OK " + to_string(leaderboard[slot].score) + ' ' + string(nameOf(leaderboard[slot])) + '\n';
+    }
+    else if (cmd == "TOP")
+    {
+        int k;
+        if (!parseInt(arg, k) || k < 0 || k > SERVER_MAX_TOP)
+        {
+            out += "ERR usage: TOP <k> (k <= " + to_string(SERVER_MAX_TOP) + ")\n";
+            return true;
+        }
+        vector<int> slots = rankRange(index.rank, 1, k);
+        out += "OK " + to_string(slots.size()) + '\n';
+        for (size_t i = 0; i < slots.size(); i++)
+            out += to_string(i + 1) + ' ' + to_string(leaderboard[slots[i]].score) + ' ' + string(nameOf(leaderboard[slots[i]])) + '\n';
+    }
+    else if (cmd == "PREFIX")
+    {
+        vector<int> slots = prefixMatches(index.prefixes, arg, SEARCH_SUGGESTIONS);
+        out += "OK " + to_string(slots.size()) + '\n';
+        for (int slot : slots)
+            out += to_string(leaderboard[slot].score) + ' ' + string(nameOf(leaderboard[slot])) + '\n';
+    }
+    else if (cmd == "FUZZY")
+    {
+        size_t sep = arg.find(' ');
+        int maxDistance;
+        if (sep == string_view::npos || !parseInt(arg.substr(0, sep), maxDistance) || maxDistance < 0 ||
+            maxDistance > FUZZY_MAX_DISTANCE)
+        {
+            out += "ERR usage: FUZZY <d> <name> (d <= " + to_string(FUZZY_MAX_DISTANCE) + ")\n";
+            return true;
+        }
+        if (arg.size() - sep - 1 > FUZZY_MAX_QUERY_BYTES)
+        {
+            out += "ERR query too long\n";
+            return true;
+        }
+        auto matches = fuzzyMatches(index.prefixes, arg.substr(sep + 1), maxDistance, SEARCH_SUGGESTIONS);
+        out += "OK " + to_string(matches.size()) + '\n';
+        for (auto &[distance, slot] : matches)
+            out += to_string(distance) + ' ' + to_string(leaderboard[slot].score) + ' ' + string(nameOf(leaderboard[slot])) + '\n';
+    }
+    else if (cmd == "PING")
+        out += "OK PONG\n";
+    else if (cmd == "QUIT")
+    {
+        out += "OK BYE\n";
+        return false;
+    }
+    else
+        out += "ERR unknown command\n";
+    return true;
+}
+
+#ifdef __linux__
+volatile sig_atomic_t serverStopping = 0;
+
+// Listen/connect target: a Unix-domain socket path, or a loopback TCP port when port > 0.
+struct ServerAddress
+{
+    string path = DEFAULT_SERVER_SOCKET;
+    int port = 0;
+};
+
+// Parse --socket PATH / --port N from argv[first...]; false (after a usage error) on a bad port.
+bool parseServerAddress(int argc, char *argv[], int first, ServerAddress &addr)
+{
+    for (int i = first; i + 1 < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--socket")
+            addr.path = argv[++i];
+        else if (arg == "--port")
+        {
+            if (!parseArg("--port", argv[++i], addr.port))
+                return false;
+            if (addr.port < 0 || addr.port > 65535)
+            {
+                cout << "Port must be between 0 and 65535.\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Bound, listening non-blocking socket (-1 on error).
+int listenOn(const ServerAddress &addr)
+{
+    int fd;
+    if (addr.port > 0)
+    {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in sa{};
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(addr.port);
+        sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) < 0 || listen(fd, 512) < 0)
+            return fd >= 0 ? (close(fd), -1) : -1;
+        return fd;
+    }
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    sockaddr_un sa{};
+    sa.sun_family = AF_UNIX;
+    if (fd < 0 || addr.path.size() >= sizeof(sa.sun_path))
+        return fd >= 0 ? (close(fd), -1) : -1;
+    memcpy(sa.sun_path, addr.path.c_str(), addr.path.size() + 1);
+    unlink(addr.path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) < 0 || listen(fd, 512) < 0)
+        return close(fd), -1;
+    return fd;
+}
+
+// Blocking client connection (-1 on error).
+int connectTo(const ServerAddress &addr)
+{
+    int fd;
+    if (addr.port > 0)
+    {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        sockaddr_in sa{};
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(addr.port);
+        sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) == 0)
+            return fd;
+    }
+    else
+    {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un sa{};
+        sa.sun_family = AF_UNIX;
+        strncpy(sa.sun_path, addr.path.c_str(), sizeof(sa.sun_path) - 1);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) == 0)
+            return fd;
+    }
+    if (fd >= 0)
+        close(fd);
+    return -1;
+}
+
+// Single-threaded epoll loop: reads whatever each connection has sent, executes every
+// complete line in order, and answers all of them with one write. Runs until SIGINT/SIGTERM.
+int runServer(const ServerAddress &addr, vector<Player> &leaderboard, LeaderboardIndex &index, WindowedBoards &windows)
+{
+    int listener = listenOn(addr);
+    if (listener < 0)
+    {
+        cout << "Could not listen on " << (addr.port > 0 ? "127.0.0.1:" + to_string(addr.port) : addr.path) << ".\n";
+        return 1;
+    }
+    signal(SIGINT, [](int)
+           { serverStopping = 1; });
+    signal(SIGTERM, [](int)
+           { serverStopping = 1; });
+    signal(SIGPIPE, SIG_IGN);
+
+    struct Connection
+    {
+        string in, out;
+        size_t sent = 0;
+        bool closing = false;
+        uint32_t interest = EPOLLIN; // events currently registered with epoll
+    };
+    unordered_map<int, Connection> connections;
+    int ep = epoll_create1(0);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listener;
+    epoll_ctl(ep, EPOLL_CTL_ADD, listener, &ev);
+    cout << "Serving " << leaderboard.size() << " players on "
+         << (addr.port > 0 ? "127.0.0.1:" + to_string(addr.port) : addr.path) << " (Ctrl+C to stop)\n";
+    cout.flush();
+
+    auto closeConnection = [&](int fd)
+    {
+        epoll_ctl(ep, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+    };
+
+    uint64_t requests = 0;
+    vector<epoll_event> events(256);
+    char buffer[65536];
+    while (!serverStopping)
+    {
+        int n = epoll_wait(ep, events.data(), events.size(), 200);
+        for (int e = 0; e < n; e++)
+        {
+            int fd = events[e].data.fd;
+            if (fd == listener)
+            {
+                int client;
+                while ((client = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK)) >= 0)
+                {
+                    int on = 1;
+                    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // no-op on Unix sockets
+                    epoll_event cev{};
+                    cev.events = EPOLLIN;
+                    cev.data.fd = client;
+                    epoll_ctl(ep, EPOLL_CTL_ADD, client, &cev);
+                    connections[client];
+                }
+                continue;
+            }
+
+            Connection &c = connections[fd];
+            if ((events[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && (c.interest & EPOLLIN))
+            {
+                ssize_t got;
+                while ((got = read(fd, buffer, sizeof(buffer))) > 0)
+                    c.in.append(buffer, got);
+                if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+                    c.closing = true;
+            }
+
+            // Execute complete lines while the response backlog is under the cap, and write
+            // the responses; repeat while the socket keeps draining and lines are waiting.
+            // A partial line waits for more bytes. Write errors other than EAGAIN (EPIPE,
+            // ECONNRESET) mean the peer is gone.
+            bool broken = false;
+            while (true)
+            {
+                size_t start = 0, eol;
+                while (c.out.size() - c.sent < SERVER_MAX_PENDING_OUTPUT && (eol = c.in.find('\n', start)) != string::npos)
+                {
+                    requests++;
+                    size_t mark = c.out.size();
+                    bool keepOpen;
+                    try
+                    {
+                        keepOpen = handleServerCommand(string_view(c.in).substr(start, eol - start), c.out, leaderboard,
+                                                       index, windows);
+                    }
+                    catch (const exception &ex)
+                    {
+                        // e.g. bad_alloc or a full name arena: fail this request, keep serving
+                        c.out.resize(mark);
+                        c.out += string("ERR ") + ex.what() + "\n";
+                        keepOpen = true;
+                    }
+                    if (!keepOpen)
+                    {
+                        c.closing = true;
+                        start = c.in.size();
+                        break;
+                    }
+                    start = eol + 1;
+                }
+                c.in.erase(0, start);
+                if (c.in.size() > (1 << 20) && c.in.find('\n') == string::npos)
+                {
+                    c.out += "ERR line too long\n";
+                    c.in.clear();
+                    c.closing = true;
+                }
+
+                while (c.sent < c.out.size())
+                {
+                    ssize_t put = write(fd, c.out.data() + c.sent, c.out.size() - c.sent);
+                    if (put < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                        break;
+                    if (put <= 0)
+                    {
+                        broken = true;
+                        break;
+                    }
+                    c.sent += put;
+                }
+                if (c.sent == c.out.size())
+                {
+                    c.out.clear();
+                    c.sent = 0;
+                }
+                else if (c.sent >= (1 << 20))
+                {
+                    c.out.erase(0, c.sent); // keep a slow reader's buffer at its unsent part
+                    c.sent = 0;
+                }
+                if (broken || !c.out.empty() || c.in.find('\n') == string::npos)
+                    break;
+            }
+            if (broken || (c.closing && c.out.empty()))
+            {
+                closeConnection(fd);
+                continue;
+            }
+
+            uint32_t interest = 0;
+            if (!c.closing && c.out.size() - c.sent < SERVER_MAX_PENDING_OUTPUT)
+                interest |= EPOLLIN;
+            if (!c.out.empty())
+                interest |= uint32_t(EPOLLOUT);
+            if (interest != c.interest)
+            {
+                epoll_event mev{};
+                mev.events = interest;
+                mev.data.fd = fd;
+                epoll_ctl(ep, EPOLL_CTL_MOD, fd, &mev);
+                c.interest = interest;
+            }
+        }
+    }
+
+    for (auto &c : connections)
+        close(c.first);
+    close(ep);
+    close(listener);
+    if (addr.port == 0)
+        unlink(addr.path.c_str());
+    cout << "\nServer stopped after " << requests << " requests.\n";
+    return 0;
+}
+
+// Load generator: leaderboard loadgen [--socket PATH | --port N] [--connections C]
+//                                      [--requests N] [--pipeline D] [--adds PERCENT]
+// Each connection thread sends batches of D requests (RANK/SEARCH of known names, AT,
+// TOP 10 and a share of ADDs) and reads the D responses, so per-request latency is
+// measured from the batch send to the arrival of that request's response.
+// Count n from an "OK <n>" reply line; false for an ERR reply or anything malformed.
+bool parseReplyCount(string_view line, size_t &n)
+{
+    if (line.substr(0, 3) != "OK ")
+        return false;
+    auto r = from_chars(line.data() + 3, line.data() + line.size(), n);
+    return r.ec == errc() && r.ptr == line.data() + line.size();
+}
+
+int runLoadGenerator(int argc, char *argv[])
+{
+    ServerAddress addr;
+    if (!parseServerAddress(argc, argv, 2, addr))
+        return 1;
+    size_t connections = 4, total = 200000, depth = 16;
+    int addPercent = 1;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "--connections")
+        {
+            if (!parseArg("--connections", argv[i + 1], connections))
+                return 1;
+            connections = max<size_t>(1, connections);
+        }
+        else if (arg == "--requests")
+        {
+            if (!parseArg("--requests", argv[i + 1], total))
+                return 1;
+            total = max<size_t>(1, total);
+        }
+        else if (arg == "--pipeline")
+        {
+            if (!parseArg("--pipeline", argv[i + 1], depth))
+                return 1;
+            depth = max<size_t>(1, depth);
+        }
+        else if (arg == "--adds")
+        {
+            if (!parseArg("--adds", argv[i + 1], addPercent))
+                return 1;
+            addPercent = max(0, min(100, addPercent));
+        }
+    }
+
+    // Learn some real names and the board size first
+    vector<string> names;
+    int probe = connectTo(addr);
+    if (probe < 0)
+    {
+        cout << "Could not connect to " << (addr.port > 0 ? "127.0.0.1:" + to_string(addr.port) : addr.path) << ".\n";
+        return 1;
+    }
+    {
+        string request = "TOP 1000\n", reply;
+        write(probe, request.data(), request.size());
+        size_t expected = string::npos, lines = 0;
+        char buffer[65536];
+        while (lines != expected + 1)
+        {
+            ssize_t got = read(probe, buffer, sizeof(buffer));
+            if (got <= 0)
+                break;
+            reply.append(buffer, got);
+            lines = count(reply.begin(), reply.end(), '\n');
+            if (expected == string::npos && lines > 0 &&
+                !parseReplyCount(string_view(reply).substr(0, reply.find('\n')), expected))
+            {
+                cout << "Server refused TOP: " << reply.substr(0, reply.find('\n')) << "\n";
+                break;
+            }
+        }
+        istringstream rows(reply);
+        string line;
+        getline(rows, line);
+        while (getline(rows, line))
+        {
+            size_t a = line.find(' '), b = line.find(' ', a + 1);
+            names.push_back(line.substr(b + 1));
+        }
+        close(probe);
+    }
+    if (names.empty())
+        names.push_back("nobody");
+
+    vector<vector<double>> latency(connections);
+    atomic<size_t> failures{0};
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (size_t t = 0; t < connections; t++)
+        threads.emplace_back([&, t]
+                             {
+            int fd = connectTo(addr);
+            if (fd < 0)
+            {
+                failures++;
+                return;
+            }
+            mt19937 rng(t + 1);
+            size_t mine = total / connections + (t < total % connections);
+            latency[t].reserve(mine);
+            string batch, in;
+            vector<int> expectTop; // per request: 1 if the response has a TOP body
+            char buffer[65536];
+            for (size_t done = 0; done < mine;)
+            {
+                size_t d = min(depth, mine - done);
+                batch.clear();
+                expectTop.assign(d, 0);
+                for (size_t i = 0; i < d; i++)
+                {
+                    unsigned roll = rng() % 100;
+                    const string &name = names[rng() % names.size()];
+                    if (roll < unsigned(addPercent))
+                        batch += "ADD " + to_string(rng() % 1000000) + " load" + to_string(t) + '_' + to_string(done + i) + '\n';
+                    else if (roll < 40)
+                        batch += "RANK " + name + '\n';
+                    else if (roll < 70)
+                        batch += "SEARCH " + name + '\n';
+                    else if (roll < 90)
+                        batch += "AT " + to_string(1 + rng() % names.size()) + '\n';
+                    else
+                    {
+                        batch += "TOP 10\n";
+                        expectTop[i] = 1;
+                    }
+                }
+                auto sent = chrono::steady_clock::now();
+                if (write(fd, batch.data(), batch.size()) != ssize_t(batch.size()))
+                {
+                    failures++;
+                    break;
+                }
+
+                // Read the d responses in order; TOP responses carry "OK n" plus n rows
+                size_t answered = 0, pos = 0, bodyLeft = 0;
+                bool ok = true;
+                while (answered < d && ok)
+                {
+                    size_t eol;
+                    while (answered < d && (eol = in.find('\n', pos)) != string::npos)
+                    {
+                        if (bodyLeft > 0)
+                            bodyLeft--;
+                        else if (expectTop[answered] && !parseReplyCount(string_view(in).substr(pos, eol - pos), bodyLeft))
+                            bodyLeft = 0; // ERR reply: no rows follow
+                        pos = eol + 1;
+                        if (bodyLeft == 0)
+                        {
+                            latency[t].push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - sent).count());
+                            answered++;
+                        }
+                    }
+                    if (answered < d)
+                    {
+                        ssize_t got = read(fd, buffer, sizeof(buffer));
+                        ok = got > 0;
+                        if (ok)
+                            in.append(buffer, got);
+                    }
+                }
+                in.erase(0, pos);
+                if (!ok)
+                {
+                    failures++;
+                    break;
+                }
+                done += d;
+            }
+            close(fd); });
+    for (auto &th : threads)
+        th.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<double> all;
+    for (auto &l : latency)
+        all.insert(all.end(), l.begin(), l.end());
+    if (all.empty())
+    {
+        cout << "No requests completed.\n";
+        return 1;
+    }
+    sort(all.begin(), all.end());
+    auto pct = [&all](double q)
+    { return all[min(all.size() - 1, size_t(q * all.size()))]; };
+    cout << all.size() << " requests over " << connections << " connections (pipeline " << depth << ") in " << fixed
+         << setprecision(3) << seconds << " s: " << setprecision(0) << all.size() / seconds << " QPS\n";
+    cout << "Latency (us): p50 " << setprecision(1) << pct(0.50) << "  p90 " << pct(0.90) << "  p99 " << pct(0.99)
+         << "  p99.9 " << pct(0.999) << "  max " << all.back() << "\n";
+    if (failures)
+        cout << failures << " connection(s) failed.\n";
+    return failures ? 1 : 0;
+}
+#endif
+
+// -------------------- External-memory sort --------------------
+
+// Ranks a players.csv that need not fit in memory. The input is streamed in blocks and
+// parsed into chunks sized to the memory budget; each chunk is sorted with one of the
+// in-memory kernels and spilled as a run file (per player: int32 score, uint32 name
+// length, name bytes). The runs are then k-way merged through a loser tree into
+// "rank,name,score" lines. Ties keep input order when the chunk kernel is stable. When
+// there are more runs than the budget or the open-file limit allows at once, groups of
+// consecutive runs are first merged into longer runs (several passes if needed).
+
+// Bytes one buffered Player costs while its chunk is sorted (record, kernel scratch, keys).
+const size_t EXTERNAL_BYTES_PER_PLAYER = 2 * sizeof(Player) + 8;
+
+// Smallest memory budget accepted: the name arena allocates in 1 MB blocks.
+const size_t EXTERNAL_MIN_BUDGET = 4 << 20;
+
+// Smallest read buffer given to one run during a merge; bounds the fan-in by the budget.
+const size_t EXTERNAL_RUN_BUFFER = 64 << 10;
+
+struct ExternalSortStats
+{
+    uint64_t records = 0, runs = 0, mergePasses = 0;
+    uint64_t inputBytes = 0, spillWritten = 0, spillRead = 0, outputBytes = 0;
+    double runMs = 0, mergeMs = 0;
+};
+
+// Buffered sequential reader over one run file.
+struct RunReader
+{
+    ifstream file;
+    vector<char> buffer;
+    size_t pos = 0, len = 0;
+    bool done = false, corrupt = false; // corrupt: ended inside a record
+    int score = 0;
+    string_view name; // valid until the next advance()
+
+    // Make at least need bytes available at pos; false at end of file.
+    bool fill(size_t need, uint64_t &bytesRead)
+    {
+        if (len - pos >= need)
+            return true;
+        memmove(buffer.data(), buffer.data() + pos, len - pos);
+        len -= pos;
+        pos = 0;
+        if (buffer.size() < need)
+            buffer.resize(need);
+        while (len < need && file)
+        {
+            file.read(buffer.data() + len, buffer.size() - len);
+            len += file.gcount();
+            bytesRead += file.gcount();
+        }
+        return len >= need;
+    }
+
+    // Load the next record as the head, or mark the run done.
+    void advance(uint64_t &bytesRead)
+    {
+        uint32_t length;
+        if (!fill(8, bytesRead))
+        {
+            done = true;
+            corrupt = len > pos || file.bad();
+            return;
+        }
+        memcpy(&score, buffer.data() + pos, 4);
+        memcpy(&length, buffer.data() + pos + 4, 4);
+        if (length > NAME_BLOCK_SIZE || !fill(8 + length, bytesRead))
+        {
+            done = corrupt = true;
+            return;
+        }
+        name = string_view(buffer.data() + pos + 8, length);
+        pos += 8 + length;
+    }
+};
+
+// Tournament tree of losers over k sources: tree[0] holds the current winner and every
+// internal node the loser of the match played there, so replacing the winner's head
+// costs one comparison per level (log2 k) on the path back to the root.
+template <typename Before>
+struct LoserTree
+{
+    int k;
+    vector<int> tree;
+    Before before; // before(a, b): source a's head goes out first; k is a sentinel that beats all
+
+    LoserTree(int sources, Before order) : k(sources), tree(sources, sources), before(order)
+    {
+        for (int s = k - 1; s >= 0; s--)
+            replay(s);
+    }
+
+    int winner() const
+    {
+        return tree[0];
+    }
+
+    // Source s has a new head: play its matches up to the root.
+    void replay(int s)
+    {
+        for (int t = (s + k) / 2; t > 0; t /= 2)
+            if (before(tree[t], s))
+                swap(s, tree[t]);
+        tree[0] = s;
+    }
+};
+
+// Buffered writer of one run file.
+struct RunWriter
+{
+    ofstream file;
+    string buffer;
+    size_t capacity;
+    uint64_t &bytesWritten;
+
+    RunWriter(const string &path, size_t bufferBytes, uint64_t &written)
+        : file(path, ios::binary | ios::trunc), capacity(bufferBytes), bytesWritten(written)
+    {
+        buffer.reserve(capacity + 64);
+    }
+
+    void put(int score, string_view name)
+    {
+        uint32_t length = name.size();
+        buffer.append(reinterpret_cast<const char *>(&score), 4);
+        buffer.append(reinterpret_cast<const char *>(&length), 4);
+        buffer.append(name);
+        if (buffer.size() >= capacity)
+            flush();
+    }
+
+    void flush()
+    {
+        file.write(buffer.data(), buffer.size());
+        bytesWritten += buffer.size();
+        buffer.clear();
+    }
+
+    // Flush and close; false if any byte failed to reach the file (e.g. disk full).
+    bool finish()
+    {
+        flush();
+        file.close();
+        return !file.fail();
+    }
+};
+
+// Temp run files of one sort. Every file created through next() is deleted when this goes
+// out of scope, so no exit path (error or not) leaves runs behind.
+struct RunFiles
+{
+    string dir, tag;
+    vector<string> created;
+
+    RunFiles(const string &tmpDir) : dir(tmpDir), tag(to_string(chrono::steady_clock::now().time_since_epoch().count())) {}
+    ~RunFiles()
+    {
+        error_code ec;
+        for (const auto &path : created)
+            filesystem::remove(path, ec);
+    }
+
+    string next()
+    {
+        created.push_back((filesystem::path(dir) / ("leaderboard_run_" + tag + "_" + to_string(created.size()) + ".bin")).string());
+        return created.back();
+    }
+};
+
+// Runs one merge may hold open: the soft open-file limit minus a few descriptors for the
+// standard streams and the merge output.
+size_t maxOpenRuns()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+        return max<size_t>(2, limit.rlim_cur > 8 ? limit.rlim_cur - 8 : 0);
+    return 1 << 16;
+#else
+    return 500; // C runtime stream limit is 512
+#endif
+}
+
+// Sort a chunk and write it as a run file, then release it; false if the write failed.
+bool spillRun(vector<Player> &chunk, NameArena &arena, int algo, const string &path, ExternalSortStats &stats)
+{
+    string algoName;
+    runSortAlgorithm(algo, chunk, algoName);
+
+    RunWriter run(path, 1 << 20, stats.spillWritten);
+    for (const auto &p : chunk)
+        run.put(p.score, nameText(arena, p.name));
+    stats.records += chunk.size();
+    stats.runs++;
+    chunk.clear();
+    arena = NameArena();
+    if (!run.finish())
+    {
+        cout << "Could not write run file " << path << ".\n";
+        return false;
+    }
+    return true;
+}
+
+// k-way merge of the given runs through a loser tree, handing each record to emit in rank
+// order (ties to the earlier run). Each run gets bufferBytes of read buffer; false if a
+// run cannot be opened or ends inside a record.
+template <typename Emit>
+bool mergeRuns(const vector<string> &paths, size_t bufferBytes, Emit emit, ExternalSortStats &stats)
+{
+    int k = paths.size();
+    vector<RunReader> runs(k);
+    for (int r = 0; r < k; r++)
+    {
+        runs[r].file.open(paths[r], ios::binary);
+        if (!runs[r].file.is_open())
+        {
+            cout << "Could not open run file " << paths[r] << ".\n";
+            return false;
+        }
+        runs[r].buffer.resize(bufferBytes);
+        runs[r].advance(stats.spillRead);
+    }
+    auto before = [&runs, k](int a, int b)
+    {
+        if (a == k || b == k)
+            return a == k && b != k; // sentinel from construction wins every match
+        if (runs[a].done || runs[b].done)
+            return !runs[a].done;
+        return runs[a].score != runs[b].score ? runs[a].score > runs[b].score : a < b;
+    };
+    LoserTree<decltype(before)> tree(k, before);
+    while (k > 0 && !runs[tree.winner()].done)
+    {
+        RunReader &top = runs[tree.winner()];
+        emit(top.score, top.name);
+        top.advance(stats.spillRead);
+        tree.replay(tree.winner());
+    }
+    for (int r = 0; r < k; r++)
+        if (runs[r].corrupt)
+        {
+            cout << "Run file " << paths[r] << " is truncated or unreadable.\n";
+            return false;
+        }
+    return true;
+}
+
+// Rank input into output using at most about budget bytes of buffers; false on I/O errors.
+bool externalSort(const string &input, const string &output, size_t budget, int algo, const string &tmpDir,
+                  ExternalSortStats &stats)
+{
+    budget = max(budget, EXTERNAL_MIN_BUDGET);
+    ifstream in(input, ios::binary);
+    if (!in.is_open())
+    {
+        cout << "Could not open " << input << ".\n";
+        return false;
+    }
+    RunFiles files(tmpDir);
+
+    // Phase 1: bounded chunks -> sorted runs
+    auto start = chrono::steady_clock::now();
+    size_t blockSize = min<size_t>(4 << 20, budget / 16);
+    size_t chunkBudget = budget - 2 * blockSize;
+    vector<char> block(blockSize);
+    size_t carry = 0;
+    vector<Player> chunk;
+    chunk.reserve(chunkBudget / EXTERNAL_BYTES_PER_PLAYER); // kept across runs, never regrown
+    NameArena arena;
+    vector<string> runs;
+    auto chunkBytes = [&]
+    { return chunk.size() * EXTERNAL_BYTES_PER_PLAYER + arenaBytes(arena); };
+    auto spill = [&]
+    {
+        runs.push_back(files.next());
+        return spillRun(chunk, arena, algo, runs.back(), stats);
+    };
+    while (true)
+    {
+        if (carry == block.size())
+            block.resize(block.size() * 2); // a single line longer than the block
+        in.read(block.data() + carry, block.size() - carry);
+        size_t got = in.gcount(), filled = carry + got;
+        stats.inputBytes += got;
+        bool eof = got == 0;
+        if (filled == 0)
+            break;
+
+        // Parse only complete lines (everything at end of file)
+        size_t end = filled;
+        if (!eof)
+        {
+            while (end > 0 && block[end - 1] != '\n')
+                end--;
+            if (end == 0)
+            {
+                carry = filled;
+                continue;
+            }
+        }
+        size_t lines = count(block.begin(), block.begin() + end, '\n') + 1;
+        if (!chunk.empty() && chunkBytes() + lines * EXTERNAL_BYTES_PER_PLAYER + end + NAME_BLOCK_SIZE > chunkBudget &&
+            !spill())
+            return false;
+        parsePlayerChunk(block.data(), block.data() + end, chunk, arena);
+        carry = filled - end;
+        memmove(block.data(), block.data() + end, carry);
+        if (eof)
+            break;
+    }
+    if (!chunk.empty() && !spill())
+        return false;
+    in.close();
+    vector<Player>().swap(chunk);
+    vector<char>().swap(block);
+    stats.runMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    // Phase 2: merge groups of at most fanIn consecutive runs until one pass is left;
+    // consecutive groups keep ties in input order
+    start = chrono::steady_clock::now();
+    size_t outCap = min<size_t>(4 << 20, budget / 8);
+    size_t fanIn = min(max<size_t>(2, (budget - outCap) / EXTERNAL_RUN_BUFFER), maxOpenRuns());
+    error_code ec;
+    while (runs.size() > fanIn)
+    {
+        vector<string> merged;
+        for (size_t g = 0; g < runs.size(); g += fanIn)
+        {
+            vector<string> group(runs.begin() + g, runs.begin() + min(g + fanIn, runs.size()));
+            if (group.size() == 1)
+            {
+                merged.push_back(group[0]);
+                continue;
+            }
+            merged.push_back(files.next());
+            RunWriter writer(merged.back(), outCap, stats.spillWritten);
+            if (!writer.file.is_open())
+            {
+                cout << "Could not create run file " << merged.back() << ".\n";
+                return false;
+            }
+            if (!mergeRuns(group, (budget - outCap) / group.size(), [&writer](int score, string_view name)
+                           { writer.put(score, name); }, stats))
+                return false;
+            if (!writer.finish())
+            {
+                cout << "Could not write run file " << merged.back() << ".\n";
+                return false;
+            }
+            for (const auto &path : group)
+                filesystem::remove(path, ec);
+        }
+        runs.swap(merged);
+        stats.mergePasses++;
+    }
+
+    // Final pass writes the ranked CSV
+    ofstream out(output, ios::binary | ios::trunc);
+    if (!out.is_open())
+    {
+        cout << "Could not open " << output << " for writing.\n";
+        return false;
+    }
+    string buffer;
+    buffer.reserve(outCap + 64);
+    uint64_t rank = 0;
+    char digits[24];
+    auto emit = [&](int score, string_view name)
+    {
+        buffer.append(digits, to_chars(digits, digits + sizeof(digits), ++rank).ptr - digits);
+        buffer += ',';
+        buffer.append(name);
+        buffer += ',';
+        buffer.append(digits, to_chars(digits, digits + sizeof(digits), score).ptr - digits);
+        buffer += '\n';
+        if (buffer.size() >= outCap)
+        {
+            out.write(buffer.data(), buffer.size());
+            stats.outputBytes += buffer.size();
+            buffer.clear();
+        }
+    };
+    if (!mergeRuns(runs, (budget - outCap) / max<size_t>(runs.size(), 1), emit, stats))
+        return false;
+    stats.mergePasses++;
+    out.write(buffer.data(), buffer.size());
+    stats.outputBytes += buffer.size();
+    out.close();
+    if (out.fail())
+    {
+        cout << "Could not write " << output << ".\n";
+        return false;
+    }
+    stats.mergeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+// leaderboard sort-external [input] [--output F] [--memory MB] [--algo N] [--tmp DIR]
+int runExternalSort(int argc, char *argv[])
+{
+    string input = "players.csv", output = "ranked.csv", tmpDir = filesystem::temp_directory_path().string();
+    size_t budgetMB = 64;
+    int algo = 10;
+    int i = 2;
+    if (argc > 2 && string(argv[2]).rfind("--", 0) != 0)
+        input = argv[i++];
+    for (; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "--output")
+            output = argv[i + 1];
+        else if (arg == "--memory")
+        {
+            if (!parseArg("--memory", argv[i + 1], budgetMB))
+                return 1;
+            budgetMB = max<size_t>(1, budgetMB);
+        }
+        else if (arg == "--algo")
+        {
+            if (!parseArg("--algo", argv[i + 1], algo))
+                return 1;
+        }
+        else if (arg == "--tmp")
+            tmpDir = argv[i + 1];
+    }
+    if (algo < 1 || algo > SORT_ALGORITHM_COUNT)
+    {
+        cout << "Unknown algorithm " << algo << ".\n";
+        return 1;
+    }
+
+    ExternalSortStats stats;
+    size_t residentBefore = residentMemoryBytes();
+    auto start = chrono::steady_clock::now();
+    bool ok = externalSort(input, output, budgetMB << 20, algo, tmpDir, stats);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (!ok)
+        return 1;
+
+    string algoName;
+    vector<Player> none;
+    runSortAlgorithm(algo, none, algoName);
+    auto mb = [](uint64_t bytes)
+    { return bytes / 1048576.0; };
+    uint64_t io = stats.inputBytes + stats.spillWritten + stats.spillRead + stats.outputBytes;
+    cout << "Ranked " << stats.records << " players from " << input << " into " << output << " with a "
+         << max<size_t>(budgetMB, EXTERNAL_MIN_BUDGET >> 20) << " MB budget (" << algoName << " runs)\n";
+    cout << fixed << setprecision(1);
+    cout << "Runs: " << stats.runs << "   Merge passes: " << stats.mergePasses << "   Run formation: " << stats.runMs << " ms   Merge: " << stats.mergeMs
+         << " ms   Wall: " << seconds * 1000 << " ms\n";
+    cout << "I/O: read " << mb(stats.inputBytes) << " MB input, wrote " << mb(stats.spillWritten) << " MB runs, read "
+         << mb(stats.spillRead) << " MB runs, wrote " << mb(stats.outputBytes) << " MB output = " << mb(io)
+         << " MB total (" << mb(io) / max(seconds, 1e-9) << " MB/s)\n";
+    size_t residentAfter = residentMemoryBytes();
+    if (residentAfter)
+        cout << "Resident memory grew by " << mb(residentAfter > residentBefore ? residentAfter - residentBefore : 0) << " MB\n";
+    return 0;
 }
 
 // -------------------- Comparison and visualization --------------------
@@ -412,11 +5042,13 @@ void compareAllAlgorithms(vector<Player> &leaderboard)
     auto measureSortTime = [&](auto sortFunc, const string &algoName)
     {
         temp = leaderboard;
+        CounterSet counters = startCounters();
         auto start = chrono::high_resolution_clock::now();
         sortFunc(temp);
         auto end = chrono::high_resolution_clock::now();
+        HardwareCounters hw = stopCounters(counters);
         double duration = chrono::duration<double, milli>(end - start).count();
-        results.push_back({algoName, duration, getComplexityInfo(algoName)});
+        results.push_back({algoName, duration, getComplexityInfo(algoName), hw});
     };
 
     // Measure all algorithms
@@ -434,6 +5066,19 @@ void compareAllAlgorithms(vector<Player> &leaderboard)
                     { heapSort(arr); }, "Heap Sort");
     measureSortTime([](auto &arr)
                     { countingSort(arr); }, "Counting Sort");
+    measureSortTime([](auto &arr)
+                    { radixSort(arr); }, "Radix Sort");
+    measureSortTime([](auto &arr)
+                    { introSort(arr); }, "Intro Sort");
+    measureSortTime([](auto &arr)
+                    { timSort(arr); }, "Tim Sort");
+    measureSortTime([](auto &arr)
+                    { string chosen;
+                      runSortAlgorithm(13, arr, chosen); }, "Auto");
+    measureSortTime([](auto &arr)
+                    { parallelMergeSort(arr, sortThreads); }, "Parallel Merge Sort");
+    measureSortTime([](auto &arr)
+                    { parallelQuickSort(arr, sortThreads); }, "Parallel Quick Sort");
 
     // Print comparison table (aligned)
     cout << "\n==================== SORTING ALGORITHM COMPARISON ====================\n";
@@ -462,64 +5107,1249 @@ void compareAllAlgorithms(vector<Player> &leaderboard)
             cout << "Time: O(n log n)          | Space: O(1)";
         else if (r.algorithm == "Counting Sort")
             cout << "Time: O(n + k)            | Space: O(n + k)";
+        else if (r.algorithm == "Radix Sort")
+            cout << "Time: O(4n)               | Space: O(n)";
+        else if (r.algorithm == "Intro Sort")
+            cout << "Time: O(n log n) worst    | Space: O(log n)";
+        else if (r.algorithm == "Tim Sort")
+            cout << "Time: O(n) .. O(n log n)  | Space: O(n)";
+        else if (r.algorithm == "Auto")
+            cout << "Time: O(n) .. O(n log n)  | Space: O(n)";
+        else if (r.algorithm == "Parallel Merge Sort")
+            cout << "Time: O(n log n / p)      | Space: O(n)";
+        else if (r.algorithm == "Parallel Quick Sort")
+            cout << "Time: O(n log n / p) avg  | Space: O(log n)";
         else
             cout << r.complexity; // fallback
 
         cout << endl;
     }
 
-    cout << string(85, '=') << "\n";
+    cout << string(85, '=') << "\n";
+
+    // Hardware counters for the same runs
+    cout << "\nHardware Counters\n";
+    cout << left << setw(22) << "Algorithm" << setw(14) << "Cycles" << setw(14) << "Instructions"
+         << setw(7) << "IPC" << setw(12) << "L1D miss" << setw(12) << "LLC miss" << "Branch miss" << endl;
+    cout << string(95, '-') << "\n";
+    for (auto &r : results)
+    {
+        cout << left << setw(22) << r.algorithm << setw(14) << formatCounter(r.counters.cycles)
+             << setw(14) << formatCounter(r.counters.instructions) << setw(7) << formatIPC(r.counters)
+             << setw(12) << formatCounter(r.counters.l1dMisses) << setw(12) << formatCounter(r.counters.llcMisses)
+             << formatCounter(r.counters.branchMisses) << endl;
+    }
+    cout << string(95, '-') << "\n";
+
+    // Console bar graph visualization
+    cout << "\nExecution Time Visualization\n";
+    cout << string(70, '-') << "\n";
+
+    double maxTime = 0.0;
+    for (auto &r : results)
+        if (r.timeTaken > maxTime)
+            maxTime = r.timeTaken;
+
+    if (maxTime == 0.0)
+        maxTime = 1.0; // prevent division by zero
+
+    for (auto &r : results)
+    {
+        int barLength = static_cast<int>((r.timeTaken / maxTime) * 40);
+        cout << left << setw(20) << r.algorithm << " | ";
+
+        for (int i = 0; i < barLength; i++)
+            cout << "_";
+
+        cout << "  " << setw(7) << fixed << setprecision(3) << r.timeTaken << " ms" << endl;
+    }
+
+    cout << string(70, '-') << "\n";
+
+    // Same input sorted as compact (score, index) keys instead of Player records
+    auto keyStart = chrono::high_resolution_clock::now();
+    vector<SortKey> keys = makeSortKeys(leaderboard), keyTemp;
+    double extractMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - keyStart).count();
+    cout << "\nKey/Index Sorting (same input, Player records vs (score, index) keys)\n";
+    cout << left << setw(22) << "Algorithm" << setw(15) << "Player (ms)" << setw(15) << "Keys (ms)" << "Speedup" << endl;
+    cout << string(70, '-') << "\n";
+    for (int algo = 1; algo <= SORT_ALGORITHM_COUNT; algo++)
+    {
+        string algoName;
+        keyTemp = keys;
+        auto start = chrono::high_resolution_clock::now();
+        runSortAlgorithm(algo, keyTemp, algoName);
+        double keyMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+
+        double playerMs = 0;
+        for (auto &r : results)
+            if (r.algorithm == algoName)
+                playerMs = r.timeTaken;
+        cout << left << setw(22) << algoName << setw(15) << fixed << setprecision(3) << playerMs
+             << setw(15) << keyMs << playerMs / max(keyMs, 1e-6) << "x" << endl;
+    }
+    auto matStart = chrono::high_resolution_clock::now();
+    temp = materializeOrder(leaderboard, keyTemp);
+    double materializeMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - matStart).count();
+    cout << "Key extraction: " << extractMs << " ms | Materialising Player order: " << materializeMs << " ms\n";
+    cout << string(70, '-') << "\n";
+
+    // Top-K without a full sort, against the fastest full sort measured above
+    const ComparisonResult *fastest = &results[0];
+    for (auto &r : results)
+        if (r.timeTaken < fastest->timeTaken)
+            fastest = &r;
+    vector<int> streamHeap;
+    for (int i = 0; i < int(leaderboard.size()); i++)
+        streamingTopInsert(streamHeap, leaderboard, i);
+    cout << "\nTop-K Queries (vs fastest full sort: " << fastest->algorithm << ", "
+         << fixed << setprecision(3) << fastest->timeTaken << " ms)\n";
+    cout << left << setw(8) << "K" << setw(18) << "Heap (ms)" << setw(18) << "Select (ms)" << "Streaming (ms)" << endl;
+    cout << string(70, '-') << "\n";
+    for (int k : {10, 100})
+    {
+        auto start = chrono::high_resolution_clock::now();
+        topKHeap(leaderboard, k);
+        auto mid = chrono::high_resolution_clock::now();
+        topKSelect(leaderboard, k);
+        auto mid2 = chrono::high_resolution_clock::now();
+        streamingTopK(streamHeap, leaderboard, k);
+        auto end = chrono::high_resolution_clock::now();
+        cout << left << setw(8) << k << setw(18) << chrono::duration<double, milli>(mid - start).count()
+             << setw(18) << chrono::duration<double, milli>(mid2 - mid).count()
+             << chrono::duration<double, milli>(end - mid2).count() << endl;
+    }
+    cout << string(70, '-') << "\n";
+
+    // Parallel speedup versus thread count, relative to the serial sorts above
+    double serialMerge = results[3].timeTaken, serialQuick = results[4].timeTaken;
+    unsigned maxThreads = max(resolveThreadCount(sortThreads), thread::hardware_concurrency());
+    cout << "\nParallel Scaling (speedup vs serial Merge / Quick Sort)\n";
+    cout << left << setw(10) << "Threads" << setw(15) << "Merge (ms)" << setw(12) << "Speedup"
+         << setw(15) << "Quick (ms)" << "Speedup" << endl;
+    cout << string(70, '-') << "\n";
+    for (unsigned t = 1;; t = min(t * 2, maxThreads))
+    {
+        temp = leaderboard;
+        auto start = chrono::high_resolution_clock::now();
+        parallelMergeSort(temp, t);
+        double mergeMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+
+        temp = leaderboard;
+        start = chrono::high_resolution_clock::now();
+        parallelQuickSort(temp, t);
+        double quickMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+
+        cout << left << setw(10) << t << setw(15) << fixed << setprecision(3) << mergeMs
+             << setw(12) << serialMerge / max(mergeMs, 1e-6) << setw(15) << quickMs
+             << serialQuick / max(quickMs, 1e-6) << endl;
+        if (t == maxThreads)
+            break;
+    }
+    cout << string(70, '-') << "\n";
+
+    // Save comparison to CSV (replaced atomically by the background writer)
+    ostringstream file;
+    file << "Algorithm,Time(ms),Complexity,Cycles,Instructions,L1DMisses,LLCMisses,BranchMisses\n";
+    for (auto &r : results)
+        file << r.algorithm << "," << r.timeTaken << "," << r.complexity << ","
+             << formatCounter(r.counters.cycles) << "," << formatCounter(r.counters.instructions) << ","
+             << formatCounter(r.counters.l1dMisses) << "," << formatCounter(r.counters.llcMisses) << ","
+             << formatCounter(r.counters.branchMisses) << "\n";
+    PersistWriter::Job job;
+    job.kind = PersistWriter::Job::Replace;
+    job.path = "comparison.csv";
+    job.bytes = file.str();
+    persistWriter.submit(move(job));
+    cout << "Comparison results queued for 'comparison.csv'\n";
+}
+
+// -------------------- Benchmark harness --------------------
+
+const vector<string> WORKLOAD_SHAPES = {"uniform", "sorted", "reversed", "few", "tail"};
+
+// Synthetic leaderboard of n players:
+//   uniform  - random scores in [0, 1000000)
+//   sorted   - already in leaderboard order (descending)
+//   reversed - ascending scores
+//   few      - only 8 distinct scores
+//   tail     - sorted, with the last 1% appended in random order
+// Names are interned into playerNames; callers that discard the board hold a TransientNames.
+vector<Player> generateWorkload(const string &shape, size_t n, unsigned seed = 42)
+{
+    mt19937 rng(seed);
+    vector<Player> lb(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        lb[i].name = internName("player" + to_string(i));
+        lb[i].score = (shape == "few") ? int(rng() % 8) * 100 : int(rng() % 1000000);
+    }
+
+    auto byScoreDesc = [](const Player &a, const Player &b)
+    { return a.score > b.score; };
+    if (shape == "sorted")
+        sort(lb.begin(), lb.end(), byScoreDesc);
+    else if (shape == "reversed")
+        sort(lb.rbegin(), lb.rend(), byScoreDesc);
+    else if (shape == "tail")
+        sort(lb.begin(), lb.end() - n / 100, byScoreDesc);
+    return lb;
+}
+
+struct BenchStats
+{
+    double minMs, medianMs, p95Ms, meanMs, stddevMs;
+};
+
+BenchStats computeStats(vector<double> samples)
+{
+    sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    double sum = 0, sq = 0;
+    for (double s : samples)
+        sum += s;
+    double mean = sum / n;
+    for (double s : samples)
+        sq += (s - mean) * (s - mean);
+    size_t p95 = min(n - 1, size_t(ceil(0.95 * n)) - 1);
+    double median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    return {samples[0], median, samples[p95], mean, sqrt(sq / n)};
+}
+
+struct BenchResult
+{
+    string algorithm, shape;
+    size_t size;
+    int reps;
+    BenchStats stats;
+};
+
+// Time run() after warmup calls; prepare() resets the input outside the timed region.
+BenchStats benchmarkRuns(int warmup, int reps, const function<void()> &prepare, const function<void()> &run)
+{
+    vector<double> samples;
+    for (int i = 0; i < warmup + reps; i++)
+    {
+        prepare();
+        auto start = chrono::steady_clock::now();
+        run();
+        auto end = chrono::steady_clock::now();
+        if (i >= warmup)
+            samples.push_back(chrono::duration<double, milli>(end - start).count());
+    }
+    return computeStats(samples);
+}
+
+void printBenchHeader()
+{
+    cout << left << setw(22) << "Algorithm" << setw(10) << "Shape" << setw(10) << "Size"
+         << setw(11) << "Min(ms)" << setw(11) << "Median" << setw(11) << "P95"
+         << setw(11) << "Stddev" << "Elements/s" << endl;
+    cout << string(100, '-') << "\n";
+}
+
+void printBenchResult(const BenchResult &r)
+{
+    cout << left << setw(22) << r.algorithm << setw(10) << r.shape << setw(10) << r.size
+         << fixed << setprecision(3) << setw(11) << r.stats.minMs << setw(11) << r.stats.medianMs
+         << setw(11) << r.stats.p95Ms << setw(11) << r.stats.stddevMs
+         << setprecision(0) << r.size / max(r.stats.medianMs / 1000, 1e-9) << endl;
+}
+
+// Append results to a CSV file (header written once) so runs can be tracked across builds.
+void writeBenchCSV(const vector<BenchResult> &results, const string &filename, const string &label)
+{
+    bool fileExists = filesystem::exists(filename);
+    ofstream file(filename, ios::app);
+    if (!file)
+    {
+        cout << "Error: Could not open " << filename << "\n";
+        return;
+    }
+    if (!fileExists)
+        file << "Label,Algorithm,Shape,Size,Reps,Min(ms),Median(ms),P95(ms),Mean(ms),Stddev(ms),Elements/s\n";
+    for (const auto &r : results)
+        file << label << "," << r.algorithm << "," << r.shape << "," << r.size << "," << r.reps << ","
+             << r.stats.minMs << "," << r.stats.medianMs << "," << r.stats.p95Ms << "," << r.stats.meanMs << ","
+             << r.stats.stddevMs << "," << r.size / max(r.stats.medianMs / 1000, 1e-9) << "\n";
+    cout << "Benchmark results appended to '" << filename << "'\n";
+}
+
+void writeBenchJSON(const vector<BenchResult> &results, const string &filename, const string &label)
+{
+    ofstream file(filename);
+    if (!file)
+    {
+        cout << "Error: Could not open " << filename << "\n";
+        return;
+    }
+    file << "{\n  \"label\": \"" << label << "\",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const auto &r = results[i];
+        file << "    {\"algorithm\": \"" << r.algorithm << "\", \"shape\": \"" << r.shape
+             << "\", \"size\": " << r.size << ", \"reps\": " << r.reps
+             << ", \"min_ms\": " << r.stats.minMs << ", \"median_ms\": " << r.stats.medianMs
+             << ", \"p95_ms\": " << r.stats.p95Ms << ", \"mean_ms\": " << r.stats.meanMs
+             << ", \"stddev_ms\": " << r.stats.stddevMs
+             << ", \"elements_per_sec\": " << r.size / max(r.stats.medianMs / 1000, 1e-9) << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    cout << "Benchmark results written to '" << filename << "'\n";
+}
+
+// Split "a,b,c" into its parts.
+vector<string> splitList(const string &list)
+{
+    vector<string> parts;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty())
+            parts.push_back(item);
+    return parts;
+}
+
+// Parse a comma-separated list of numbers for flag; prints a usage error and returns false on a bad item.
+template <typename T>
+bool parseArgList(const char *flag, const string &list, vector<T> &values)
+{
+    values.clear();
+    for (auto &item : splitList(list))
+    {
+        T value;
+        if (!parseArg(flag, item, value))
+            return false;
+        values.push_back(value);
+    }
+    return true;
+}
+
+// Largest input on which the default benchmark runs still time O(n^2) cases.
+const size_t QUADRATIC_BENCH_LIMIT = 20000;
+
+// Cases that run in O(n^2): the elementary sorts, and the classic Lomuto quick sort on
+// presorted or duplicate-heavy shapes.
+bool quadraticCase(int algo, const string &shape)
+{
+    return algo <= 3 || (algo == 5 && shape != "uniform");
+}
+
+// Non-interactive benchmark: leaderboard bench [options]
+//   --sizes N,...    input sizes (default 10000)
+//   --shapes S,...   uniform,sorted,reversed,few,tail or all (default all)
+//   --algos A,...    option 2 algorithm numbers (default all; O(n^2) cases skipped above 20000)
+//   --reps R         timed repetitions (default 10)
+//   --warmup W       untimed warmup runs (default 2)
+//   --csv FILE       append results as CSV (default bench_results.csv)
+//   --json FILE      also write results as JSON
+//   --label TEXT     tag stored with every row (default: build timestamp)
+int runBenchmark(int argc, char *argv[])
+{
+    vector<size_t> sizes = {10000};
+    vector<string> shapes = WORKLOAD_SHAPES;
+    vector<int> algos;
+    int reps = 10, warmup = 2;
+    string csvFile = "bench_results.csv", jsonFile, label = string(__DATE__) + " " + __TIME__;
+
+    for (int i = 2; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        string value = hasValue ? argv[i + 1] : "";
+        if (arg == "--sizes" && hasValue)
+        {
+            sizes.clear();
+            for (auto &s : splitList(value))
+            {
+                size_t n;
+                if (!parseArg("--sizes", s, n))
+                    return 1;
+                sizes.push_back(n);
+            }
+            i++;
+        }
+        else if (arg == "--shapes" && hasValue)
+        {
+            if (value != "all")
+                shapes = splitList(value);
+            i++;
+        }
+        else if (arg == "--algos" && hasValue)
+        {
+            for (auto &a : splitList(value))
+            {
+                int algo;
+                if (!parseArg("--algos", a, algo))
+                    return 1;
+                if (algo < 1 || algo > SORT_ALGORITHM_COUNT)
+                {
+                    cout << "Unknown algorithm " << algo << " (expected 1-" << SORT_ALGORITHM_COUNT << ").\n";
+                    return 1;
+                }
+                algos.push_back(algo);
+            }
+            i++;
+        }
+        else if (arg == "--reps" && hasValue)
+        {
+            if (!parseArg("--reps", argv[++i], reps))
+                return 1;
+            reps = max(1, reps);
+        }
+        else if (arg == "--warmup" && hasValue)
+        {
+            if (!parseArg("--warmup", argv[++i], warmup))
+                return 1;
+            warmup = max(0, warmup);
+        }
+        else if (arg == "--csv" && hasValue)
+            csvFile = argv[++i];
+        else if (arg == "--json" && hasValue)
+            jsonFile = argv[++i];
+        else if (arg == "--label" && hasValue)
+            label = argv[++i];
+        else if (arg == "--threads" && hasValue)
+        {
+            if (!parseArg("--threads", argv[++i], sortThreads))
+                return 1;
+        }
+        else if (arg == "--key-sort")
+            keySortMode = true;
+        else
+        {
+            cout << "Unknown benchmark option or missing value: " << arg << "\n";
+            return 1;
+        }
+    }
+    bool allAlgos = algos.empty();
+    if (allAlgos)
+        for (int a = 1; a <= SORT_ALGORITHM_COUNT; a++)
+            algos.push_back(a);
+
+    vector<BenchResult> results;
+    printBenchHeader();
+    for (size_t n : sizes)
+    {
+        for (const auto &shape : shapes)
+        {
+            TransientNames scratch;
+            vector<Player> input = generateWorkload(shape, n);
+            vector<SortKey> inputKeys = makeSortKeys(input);
+            for (int algo : algos)
+            {
+                if (allAlgos && n > QUADRATIC_BENCH_LIMIT && quadraticCase(algo, shape))
+                    continue; // would dominate the run
+
+                string algoName;
+                vector<Player> temp;
+                vector<SortKey> keys;
+                BenchStats stats = benchmarkRuns(
+                    warmup, reps, [&]
+                    {
+                        if (keySortMode)
+                            keys = inputKeys;
+                        else
+                            temp = input; },
+                    [&]
+                    {
+                        if (keySortMode)
+                            runSortAlgorithm(algo, keys, algoName);
+                        else
+                            runSortAlgorithm(algo, temp, algoName); });
+                if (algoName.empty())
+                {
+                    cout << "Unknown algorithm number " << algo << "\n";
+                    return 1;
+                }
+                results.push_back({keySortMode ? algoName + " (keys)" : algoName, shape, n, reps, stats});
+                printBenchResult(results.back());
+            }
+        }
+    }
+
+    if (!csvFile.empty())
+        writeBenchCSV(results, csvFile, label);
+    if (!jsonFile.empty())
+        writeBenchJSON(results, jsonFile, label);
+    return 0;
+}
+
+// Unique-name add benchmark: leaderboard bench-names [--sizes N,...] [--adds A]
+// Times adds (half of them reusing an existing name) on boards of N existing players,
+// with the suffix map versus the O(n) generateUniqueName scan.
+int runNameBenchmark(int argc, char *argv[])
+{
+    vector<size_t> sizes = {100000, 1000000};
+    int adds = 10000;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "--sizes")
+        {
+            if (!parseArgList("--sizes", argv[i + 1], sizes))
+                return 1;
+        }
+        else if (arg == "--adds")
+        {
+            if (!parseArg("--adds", argv[i + 1], adds))
+                return 1;
+            adds = max(1, adds);
+        }
+    }
+
+    cout << left << setw(12) << "Existing" << setw(20) << "Suffix map adds/s" << setw(20) << "Scan adds/s" << "Speedup" << endl;
+    cout << string(60, '-') << "\n";
+    for (size_t n : sizes)
+    {
+        TransientNames scratch;
+        vector<Player> base = generateWorkload("uniform", n);
+        auto runAdds = [&](int count, bool legacy)
+        {
+            vector<Player> lb = base;
+            LeaderboardIndex idx;
+            rebuildIndex(idx, lb);
+            mt19937 rng(7);
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < count; i++)
+            {
+                string name = (i % 2) ? "player" + to_string(rng() % n) : "new" + to_string(i);
+                name = legacy ? generateUniqueName(name, lb) : uniqueName(idx, name);
+                lb.push_back({internName(name), int(rng() % 1000000)});
+                indexPlayer(idx, lb, lb.size() - 1);
+            }
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            return count / max(seconds, 1e-9);
+        };
+
+        double mapRate = runAdds(adds, false);
+        double scanRate = runAdds(max<int>(10, min<size_t>(adds, 20000000 / max<size_t>(n, 1))), true);
+        cout << left << setw(12) << n << fixed << setprecision(0) << setw(20) << mapRate << setw(20) << scanRate
+             << setprecision(1) << mapRate / max(scanRate, 1e-9) << "x" << endl;
+    }
+    return 0;
+}
+
+// Auto vs fixed algorithms: leaderboard bench-auto [--sizes N,...] [--reps R]
+// Runs every fixed algorithm and Auto on each workload shape and reports Auto / best.
+// Quadratic cases (see quadraticCase) are skipped above 20000 players.
+int runAutoBenchmark(int argc, char *argv[])
+{
+    vector<size_t> sizes = {10000, 200000};
+    int reps = 5;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "--sizes")
+        {
+            if (!parseArgList("--sizes", argv[i + 1], sizes))
+                return 1;
+        }
+        else if (arg == "--reps")
+        {
+            if (!parseArg("--reps", argv[i + 1], reps))
+                return 1;
+            reps = max(1, reps);
+        }
+    }
+
+    cout << left << setw(10) << "Shape" << setw(10) << "Size" << setw(22) << "Best fixed" << setw(12) << "Best (ms)"
+         << setw(12) << "Auto (ms)" << setw(22) << "Auto picked" << "Auto/Best" << endl;
+    cout << string(100, '-') << "\n";
+    double worstRatio = 0;
+    for (size_t n : sizes)
+    {
+        for (const auto &shape : WORKLOAD_SHAPES)
+        {
+            TransientNames scratch;
+            vector<Player> input = generateWorkload(shape, n), temp;
+            string bestName, algoName;
+            double bestMs = numeric_limits<double>::max();
+            for (int algo = 1; algo < 13; algo++)
+            {
+                if (n > QUADRATIC_BENCH_LIMIT && quadraticCase(algo, shape))
+                    continue;
+                BenchStats stats = benchmarkRuns(1, reps, [&]
+                                                 { temp = input; },
+                                                 [&]
+                                                 { runSortAlgorithm(algo, temp, algoName); });
+                if (stats.medianMs < bestMs)
+                {
+                    bestMs = stats.medianMs;
+                    bestName = algoName;
+                }
+            }
+
+            BenchStats autoStats = benchmarkRuns(1, reps, [&]
+                                                 { temp = input; },
+                                                 [&]
+                                                 { runSortAlgorithm(13, temp, algoName); });
+            double ratio = autoStats.medianMs / max(bestMs, 1e-9);
+            worstRatio = max(worstRatio, ratio);
+            cout << left << setw(10) << shape << setw(10) << n << setw(22) << bestName << fixed << setprecision(3)
+                 << setw(12) << bestMs << setw(12) << autoStats.medianMs << setw(22) << lastAutoDecision.chosen
+                 << setprecision(2) << ratio << "x" << endl;
+        }
+    }
+    cout << string(100, '-') << "\n";
+    cout << "Worst Auto / best fixed ratio: " << fixed << setprecision(2) << worstRatio << "x\n";
+    return 0;
+}
+
+// Group-commit writer throughput: leaderboard bench-writer [--records N] [--batches B,...]
+// Appends N player rows through the background writer at each fsync batch size and reports
+// durable writes/s (timed until flush() returns), write()/fsync() counts and the time the
+// submitting thread spends per record. "legacy" is the old open/append/close per row (no fsync).
+int runWriterBenchmark(int argc, char *argv[])
+{
+    size_t count = 20000;
+    vector<size_t> batches = {1, 8, 64, 512};
+    const string path = "writer_bench.csv";
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "--records")
+        {
+            if (!parseArg("--records", argv[i + 1], count))
+                return 1;
+            count = max<size_t>(1, count);
+        }
+        else if (arg == "--batches")
+        {
+            if (!parseArgList("--batches", argv[i + 1], batches))
+                return 1;
+            for (auto &b : batches)
+                b = max<size_t>(1, b);
+        }
+    }
+    vector<Player> rows = generateWorkload("uniform", count);
+
+    cout << left << setw(10) << "Batch" << setw(16) << "Writes/s" << setw(12) << "write()" << setw(12) << "fsync()"
+         << setw(16) << "Rows/fsync" << "Submit (us/row)" << endl;
+    cout << string(80, '-') << "\n";
+
+    filesystem::remove(path);
+    auto start = chrono::steady_clock::now();
+    for (const auto &p : rows)
+    {
+        ofstream file(path, ios::app);
+        file << nameOf(p) << "," << p.score << "\n";
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << left << setw(10) << "legacy" << fixed << setprecision(0) << setw(16) << count / max(seconds, 1e-9)
+         << setw(12) << count << setw(12) << 0 << setw(16) << "-" << setprecision(3) << seconds * 1e6 / count << endl;
+
+    for (size_t batch : batches)
+    {
+        filesystem::remove(path);
+        PersistWriter writer;
+        writer.syncBatch = batch;
+        writer.syncIntervalMs = 1000;
+        start = chrono::steady_clock::now();
+        for (const auto &p : rows)
+        {
+            PersistWriter::Job job;
+            job.kind = PersistWriter::Job::Append;
+            job.path = path;
+            job.bytes = string(nameOf(p)) + "," + to_string(p.score) + "\n";
+            writer.submit(move(job));
+        }
+        double submitSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        writer.flush();
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << left << setw(10) << batch << fixed << setprecision(0) << setw(16) << count / max(seconds, 1e-9)
+             << setw(12) << writer.writeCalls << setw(12) << writer.syncCalls << setprecision(1) << setw(16)
+             << double(count) / max<uint64_t>(writer.syncCalls, 1) << setprecision(3) << submitSeconds * 1e6 / count << endl;
+    }
+    filesystem::remove(path);
+    return 0;
+}
+
+// Windowed boards under load: leaderboard bench-windows [--submissions N] [--players P] [--rate R]
+// Streams N submissions from P players at R per simulated second (so daily windows roll
+// over during the run), then reports per window: size, heap bytes, expiries, and the
+// mean latency of top-10 and rank-of-player queries. "Scan" is the same top-10 answered
+// by re-aggregating the raw submission log for that window, for reference.
+int runWindowBenchmark(int argc, char *argv[])
+{
+    size_t count = 2000000, players = 100000;
+    double rate = 5;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "--submissions")
+        {
+            if (!parseArg("--submissions", argv[i + 1], count))
+                return 1;
+            count = max<size_t>(1, count);
+        }
+        else if (arg == "--players")
+        {
+            if (!parseArg("--players", argv[i + 1], players))
+                return 1;
+            players = max<size_t>(1, players);
+        }
+        else if (arg == "--rate")
+        {
+            if (!parseArg("--rate", argv[i + 1], rate))
+                return 1;
+            rate = max(1e-3, rate);
+        }
+    }
+
+    struct Submission
+    {
+        uint32_t player;
+        int score;
+        int64_t ts;
+    };
+    const int64_t startTs = 1700438400; // Monday 2023-11-20 00:00 UTC
+    mt19937 rng(42);
+    vector<string> names(players);
+    for (size_t i = 0; i < players; i++)
+        names[i] = "player" + to_string(i);
+    vector<Submission> log(count);
+    for (size_t i = 0; i < count; i++)
+        log[i] = {uint32_t(rng() % players), int(rng() % 1000000), startTs + int64_t(i / rate)};
+
+    WindowedBoards wb;
+    auto start = chrono::steady_clock::now();
+    for (const auto &s : log)
+        windowedSubmit(wb, names[s.player], s.score, s.ts);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << count << " submissions over " << fixed << setprecision(1) << (log.back().ts - startTs) / 86400.0
+         << " simulated days: " << setprecision(0) << count / max(seconds, 1e-9) << " submissions/s\n\n";
+
+    cout << left << setw(10) << "Window" << setw(10) << "Players" << setw(12) << "Memory(MB)" << setw(10) << "Expiries"
+         << setw(14) << "Top-10 (us)" << setw(14) << "Rank (us)" << "Scan top-10 (ms)" << endl;
+    cout << string(86, '-') << "\n";
+    const int queries = 1000;
+    for (const auto &board : wb.boards)
+    {
+        start = chrono::steady_clock::now();
+        volatile size_t sink = 0;
+        for (int q = 0; q < queries; q++)
+            sink += rankRange(board.rank, 1, 10).size();
+        double topUs = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / queries;
+
+        start = chrono::steady_clock::now();
+        for (int q = 0; q < queries; q++)
+        {
+            int slot = nameLookup(board.names, names[rng() % players]);
+            if (slot >= 0)
+                sink += rankOf(board.rank, board.entries, slot);
+        }
+        double rankUs = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / queries;
+
+        // Reference: aggregate best-per-player for the current window from the raw log
+        start = chrono::steady_clock::now();
+        unordered_map<uint32_t, int> best;
+        for (const auto &s : log)
+            if (windowOf(board, s.ts) == board.current)
+            {
+                auto it = best.emplace(s.player, s.score).first;
+                it->second = max(it->second, s.score);
+            }
+        vector<pair<int, uint32_t>> top;
+        for (const auto &b : best)
+            top.push_back({b.second, b.first});
+        partial_sort(top.begin(), top.begin() + min<size_t>(10, top.size()), top.end(), greater<>());
+        double scanMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        sink += top.size();
+
+        cout << left << setw(10) << board.label << setw(10) << board.entries.size() << fixed << setprecision(2)
+             << setw(12) << windowBoardBytes(board) / 1e6 << setw(10) << board.expiries << setprecision(3) << setw(14)
+             << topUs << setw(14) << rankUs << scanMs << endl;
+    }
+    return 0;
+}
+
+// MPSC ingestion stress test: leaderboard bench-ingest [--producers P,...] [--submissions N]
+// P producer threads push N submissions in total (unique names, random scores) through the
+// lock-free queue; one applier drains them into a fresh leaderboard, indexes and a scratch
+// CSV. Reports sustained submissions/s (until the last one is applied) and enqueue latency
+// percentiles, which include time spent waiting while the queue is full.
+int runIngestBenchmark(int argc, char *argv[])
+{
+    size_t count = 1000000;
+    vector<size_t> producerCounts = {1, 2, 4, 8};
+    const string path = "ingest_bench.csv";
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "--submissions")
+        {
+            if (!parseArg("--submissions", argv[i + 1], count))
+                return 1;
+            count = max<size_t>(1, count);
+        }
+        else if (arg == "--producers")
+        {
+            if (!parseArgList("--producers", argv[i + 1], producerCounts))
+                return 1;
+            for (auto &n : producerCounts)
+                n = max<size_t>(1, n);
+        }
+    }
+
+    cout << left << setw(12) << "Producers" << setw(16) << "Submissions/s" << setw(12) << "Batches" << setw(14)
+         << "Avg batch" << setw(14) << "p50 (ns)" << setw(14) << "p99 (ns)" << "Max (ns)" << endl;
+    cout << string(94, '-') << "\n";
+    for (size_t producers : producerCounts)
+    {
+        filesystem::remove(path);
+        vector<Player> lb;
+        LeaderboardIndex index;
+        lb.reserve(count);
+        vector<function<void(const function<void(ScoreSubmission &)> &)>> work;
+        for (size_t p = 0; p < producers; p++)
+            work.push_back([p, producers, count](const function<void(ScoreSubmission &)> &push)
+                           {
+                mt19937 rng(p + 1);
+                ScoreSubmission s;
+                for (size_t i = p; i < count; i += producers)
+                {
+                    s.name = "p" + to_string(i);
+                    s.score = rng() % 1000000;
+                    push(s);
+                } });
+
+        IngestResult r = concurrentIngest(work, lb, index, nullptr, path, true);
+        persistWriter.flush();
 
-    // Console bar graph visualization
-    cout << "\nExecution Time Visualization\n";
-    cout << string(70, '-') << "\n";
+        vector<double> &ns = r.enqueueNs;
+        auto percentile = [&ns](double q)
+        {
+            size_t k = min(ns.size() - 1, size_t(q * ns.size()));
+            nth_element(ns.begin(), ns.begin() + k, ns.end());
+            return ns[k];
+        };
+        double p50 = percentile(0.50), p99 = percentile(0.99), worst = *max_element(ns.begin(), ns.end());
+        cout << left << setw(12) << producers << fixed << setprecision(0) << setw(16) << r.applied / max(r.seconds, 1e-9)
+             << setw(12) << r.batches << setw(14) << double(r.applied) / max<size_t>(r.batches, 1) << setw(14) << p50
+             << setw(14) << p99 << worst << endl;
+    }
+    persistWriter.shutdown();
+    filesystem::remove(path);
+    return 0;
+}
 
-    double maxTime = 0.0;
-    for (auto &r : results)
-        if (r.timeTaken > maxTime)
-            maxTime = r.timeTaken;
+// Multi-board engine under concurrent writes:
+//   leaderboard bench-engine [--boards B] [--players P] [--readers R,...] [--seconds S] [--batch K]
+// Fills B boards with P players each, then for each reader count runs one writer thread
+// publishing batches of K submissions to random boards while R reader threads issue
+// lock-free top-10 and rank-of queries for S seconds.
+int runEngineBenchmark(int argc, char *argv[])
+{
+    size_t boards = 64, players = 10000, batchSize = 64;
+    double seconds = 1;
+    unsigned hw = max(1u, thread::hardware_concurrency());
+    vector<size_t> readerCounts;
+    for (size_t r = 1; r <= max(4u, hw); r *= 2)
+        readerCounts.push_back(r);
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "--boards")
+        {
+            if (!parseArg("--boards", argv[i + 1], boards))
+                return 1;
+            boards = max<size_t>(1, boards);
+        }
+        else if (arg == "--players")
+        {
+            if (!parseArg("--players", argv[i + 1], players))
+                return 1;
+            players = max<size_t>(1, players);
+        }
+        else if (arg == "--batch")
+        {
+            if (!parseArg("--batch", argv[i + 1], batchSize))
+                return 1;
+            batchSize = max<size_t>(1, batchSize);
+        }
+        else if (arg == "--seconds")
+        {
+            if (!parseArg("--seconds", argv[i + 1], seconds))
+                return 1;
+            seconds = max(0.01, seconds);
+        }
+        else if (arg == "--readers")
+        {
+            if (!parseArgList("--readers", argv[i + 1], readerCounts))
+                return 1;
+            for (auto &n : readerCounts)
+                n = max<size_t>(1, n);
+        }
+    }
 
-    if (maxTime == 0.0)
-        maxTime = 1.0; // prevent division by zero
+    vector<string> boardNames(boards);
+    for (size_t b = 0; b < boards; b++)
+        boardNames[b] = "mode" + to_string(b % 8) + "-region" + to_string(b / 8);
+    LeaderboardEngine engine;
+    mt19937 rng(1);
+    auto fillStart = chrono::steady_clock::now();
+    for (const auto &name : boardNames)
+    {
+        vector<pair<string, int>> rows(players);
+        for (size_t p = 0; p < players; p++)
+            rows[p] = {"player" + to_string(p), int(rng() % 1000000)};
+        engineSubmit(engine, name, move(rows));
+    }
+    cout << boards << " boards x " << players << " players loaded in " << fixed << setprecision(1)
+         << chrono::duration<double, milli>(chrono::steady_clock::now() - fillStart).count() << " ms ("
+         << hw << " hardware threads)\n\n";
 
-    for (auto &r : results)
+    cout << left << setw(10) << "Readers" << setw(16) << "Reads/s" << setw(18) << "Reads/s/reader" << setw(14)
+         << "p99 read (us)" << setw(16) << "Writes/s" << "Publishes" << endl;
+    cout << string(84, '-') << "\n";
+    for (size_t readers : readerCounts)
     {
-        int barLength = static_cast<int>((r.timeTaken / maxTime) * 40);
-        cout << left << setw(18) << r.algorithm << " | ";
+        atomic<bool> stop{false};
+        atomic<uint64_t> writes{0}, publishes{0};
+        thread writer([&]
+                      {
+            mt19937 wrng(7);
+            while (!stop.load(memory_order_relaxed))
+            {
+                vector<pair<string, int>> batch(batchSize);
+                for (auto &row : batch)
+                    row = {"player" + to_string(wrng() % (players * 2)), int(wrng() % 1100000)};
+                engineSubmit(engine, boardNames[wrng() % boards], move(batch));
+                writes += batchSize;
+                publishes++;
+            } });
 
-        for (int i = 0; i < barLength; i++)
-            cout << "_";
+        vector<uint64_t> reads(readers);
+        vector<vector<float>> latency(readers);
+        vector<thread> threads;
+        for (size_t r = 0; r < readers; r++)
+            threads.emplace_back([&, r]
+                                 {
+                mt19937 rrng(100 + r);
+                string player;
+                uint64_t n = 0;
+                while (!stop.load(memory_order_relaxed))
+                {
+                    const string &board = boardNames[rrng() % boards];
+                    bool sample = (n & 15) == 0;
+                    auto t0 = sample ? chrono::steady_clock::now() : chrono::steady_clock::time_point();
+                    if (n & 1)
+                        engineTop(engine, board, 10);
+                    else
+                    {
+                        player = "player" + to_string(rrng() % players);
+                        engineRankOf(engine, board, player);
+                    }
+                    if (sample)
+                        latency[r].push_back(chrono::duration<float, micro>(chrono::steady_clock::now() - t0).count());
+                    n++;
+                }
+                reads[r] = n; });
 
-        cout << "  " << setw(7) << fixed << setprecision(3) << r.timeTaken << " ms" << endl;
+        this_thread::sleep_for(chrono::duration<double>(seconds));
+        stop = true;
+        for (auto &t : threads)
+            t.join();
+        writer.join();
+
+        uint64_t totalReads = 0;
+        vector<float> all;
+        for (size_t r = 0; r < readers; r++)
+        {
+            totalReads += reads[r];
+            all.insert(all.end(), latency[r].begin(), latency[r].end());
+        }
+        size_t k = all.empty() ? 0 : min(all.size() - 1, size_t(0.99 * all.size()));
+        if (!all.empty())
+            nth_element(all.begin(), all.begin() + k, all.end());
+        cout << left << setw(10) << readers << fixed << setprecision(0) << setw(16) << totalReads / seconds << setw(18)
+             << totalReads / seconds / readers << setprecision(2) << setw(14) << (all.empty() ? 0.0f : all[k])
+             << setprecision(0) << setw(16) << writes / seconds << publishes << endl;
     }
+    return 0;
+}
 
-    cout << string(70, '-') << "\n";
+// -------------------- Main program & menu --------------------
 
-    // Save comparison to CSV
-    ofstream file("comparison.csv");
-    if (file)
+// Name search paths: leaderboard bench-search [--sizes N,...] [--queries Q] [--limit L]
+// Times exact lookups through every option 5 method plus the trie, then first-L prefix
+// and fuzzy (edit distance 1 and 2) lookups against a full scan of the names. Scans
+// run fewer queries on large boards; all figures are microseconds per query.
+int runSearchBenchmark(int argc, char *argv[])
+{
+    vector<size_t> sizes = {100000, 1000000};
+    int queries = 2000, limit = SEARCH_SUGGESTIONS;
+    for (int i = 2; i + 1 < argc; i += 2)
     {
-        file << "Algorithm,Time(ms),Complexity\n";
-        for (auto &r : results)
-            file << r.algorithm << "," << r.timeTaken << "," << r.complexity << "\n";
-        file.close();
-        cout << "Comparison results saved to 'comparison.csv'\n";
+        string arg = argv[i];
+        if (arg == "--sizes")
+        {
+            if (!parseArgList("--sizes", argv[i + 1], sizes))
+                return 1;
+        }
+        else if (arg == "--queries")
+        {
+            if (!parseArg("--queries", argv[i + 1], queries))
+                return 1;
+            queries = max(1, queries);
+        }
+        else if (arg == "--limit")
+        {
+            if (!parseArg("--limit", argv[i + 1], limit))
+                return 1;
+            limit = max(1, limit);
+        }
     }
-    else
+
+    size_t sink = 0;
+    for (size_t n : sizes)
     {
-        cout << "Error: Could not save to comparison.csv\n";
+        TransientNames scratch;
+        vector<Player> lb = generateWorkload("uniform", n);
+        LeaderboardIndex idx;
+        rebuildIndex(idx, lb);
+        auto buildStart = chrono::steady_clock::now();
+        PrefixIndex trie;
+        for (int i = 0; i < int(lb.size()); i++)
+            prefixInsert(trie, lb, i);
+        double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - buildStart).count();
+
+        // Exact names, 1-3 digit prefixes and one-substitution typos of existing players
+        mt19937 rng(11);
+        vector<string> names(queries), prefixes(queries), typos(queries);
+        for (int q = 0; q < queries; q++)
+        {
+            names[q] = "player" + to_string(rng() % n);
+            prefixes[q] = names[q].substr(0, min<size_t>(names[q].size(), 7 + rng() % 3));
+            typos[q] = names[q];
+            typos[q][rng() % typos[q].size()] = 'a' + rng() % 26;
+        }
+
+        auto perQuery = [&](int count, auto &&query)
+        {
+            count = max(1, min(count, queries));
+            auto start = chrono::steady_clock::now();
+            for (int q = 0; q < count; q++)
+                sink += query(q);
+            return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / count;
+        };
+        int scanQueries = int(20000000 / max<size_t>(n, 1)), sortQueries = int(2000000 / max<size_t>(n, 1));
+
+        vector<pair<string, double>> rows; // exact, then prefix, then fuzzy; each group starts with its scan
+        rows.push_back({"Linear scan (exact)", perQuery(scanQueries, [&](int q)
+                                                         { return linearSearch(lb, names[q]); })});
+        rows.push_back({"Sort + binary (exact)", perQuery(sortQueries, [&](int q)
+                                                           {
+            vector<Player> temp = lb;
+            sort(temp.begin(), temp.end(), [](auto &a, auto &b)
+                 { return nameOf(a) < nameOf(b); });
+            return binarySearch(temp, names[q]); })});
+        rows.push_back({"Hash index (exact)", perQuery(queries, [&](int q)
+                                                        { return nameLookup(idx.names, names[q]); })});
+        rows.push_back({"Trie (exact)", perQuery(queries, [&](int q)
+                                                  { return prefixLookup(idx.prefixes, names[q]); })});
+        rows.push_back({"Scan prefix (first " + to_string(limit) + ")", perQuery(scanQueries, [&](int q)
+                                                                                 {
+            vector<int> hits;
+            for (int i = 0; i < int(lb.size()); i++)
+                if (nameOf(lb[i]).substr(0, prefixes[q].size()) == prefixes[q])
+                    hits.push_back(i);
+            size_t k = min<size_t>(limit, hits.size());
+            partial_sort(hits.begin(), hits.begin() + k, hits.end(), [&lb](int a, int b)
+                         { return nameOf(lb[a]) < nameOf(lb[b]); });
+            return k; })});
+        rows.push_back({"Trie prefix (first " + to_string(limit) + ")", perQuery(queries, [&](int q)
+                                                                                 { return prefixMatches(idx.prefixes, prefixes[q], limit).size(); })});
+        rows.push_back({"Scan fuzzy (d <= 2)", perQuery(scanQueries / 20, [&](int q)
+                                                         {
+            size_t hits = 0;
+            for (const auto &p : lb)
+                hits += editDistance(nameOf(p), typos[q]) <= 2;
+            return hits; })});
+        for (int d = 1; d <= 2; d++)
+            rows.push_back({"Trie fuzzy (d <= " + to_string(d) + ")", perQuery(queries, [&](int q)
+                                                                             { return fuzzyMatches(idx.prefixes, typos[q], d, limit).size(); })});
+
+        cout << "\n" << n << " players: trie build " << fixed << setprecision(1) << buildMs << " ms, "
+             << trie.nodes.size() << " nodes, " << prefixIndexBytes(trie) / 1048576.0 << " MB (hash index "
+             << nameIndexBytes(idx.names) / 1048576.0 << " MB)\n";
+        cout << left << setw(26) << "Method" << setw(16) << "us/query" << "Speedup vs scan" << endl;
+        cout << string(57, '-') << "\n";
+        for (size_t r = 0; r < rows.size(); r++)
+        {
+            double scan = rows[r < 4 ? 0 : r < 6 ? 4 : 6].second;
+            cout << left << setw(26) << rows[r].first << setprecision(3) << setw(16) << rows[r].second << setprecision(1)
+                 << scan / max(rows[r].second, 1e-9) << "x" << endl;
+        }
     }
+    return sink == size_t(-1); // keeps the queries from being optimized away
 }
 
-// -------------------- Main program & menu --------------------
-
-int main()
+int main(int argc, char *argv[])
 {
     vector<Player> leaderboard;
+    LeaderboardIndex boardIndex;
+    vector<Player> lastView; // last board shown by option 2, for a deferred history save
+    WindowedBoards windows;
+    LeaderboardEngine engine;
+    string lastViewName;
     int choice;
 
+    // Subcommands run without the menu
+    if (argc > 1 && string(argv[1]) == "bench")
+        return runBenchmark(argc, argv);
+    if (argc > 1 && string(argv[1]) == "bench-names")
+        return runNameBenchmark(argc, argv);
+    if (argc > 1 && string(argv[1]) == "bench-auto")
+        return runAutoBenchmark(argc, argv);
+    if (argc > 1 && string(argv[1]) == "bench-writer")
+        return runWriterBenchmark(argc, argv);
+    if (argc > 1 && string(argv[1]) == "bench-windows")
+        return runWindowBenchmark(argc, argv);
+    if (argc > 1 && string(argv[1]) == "bench-ingest")
+        return runIngestBenchmark(argc, argv);
+    if (argc > 1 && string(argv[1]) == "bench-engine")
+        return runEngineBenchmark(argc, argv);
+    if (argc > 1 && string(argv[1]) == "bench-search")
+        return runSearchBenchmark(argc, argv);
+    if (argc > 1 && string(argv[1]) == "sort-external")
+        return runExternalSort(argc, argv);
+    if (argc > 1 && (string(argv[1]) == "serve" || string(argv[1]) == "loadgen"))
+    {
+#ifdef __linux__
+        // leaderboard serve [--socket PATH | --port N]   (see "Socket server" for the protocol)
+        if (string(argv[1]) == "loadgen")
+            return runLoadGenerator(argc, argv);
+        ServerAddress addr;
+        if (!parseServerAddress(argc, argv, 2, addr))
+            return 1;
+        ensureCSVExists();
+        if (!(playerSnapshotIsFresh() && loadPlayerSnapshot(leaderboard, &boardIndex)))
+            loadPlayersFromCSVParallel(leaderboard, "players.csv", &boardIndex);
+        loadSubmissions(windows);
+        int status = runServer(addr, leaderboard, boardIndex, windows);
+        persistWriter.shutdown();
+        return status;
+#else
+        cout << "Server mode needs Linux (epoll).\n";
+        return 1;
+#endif
+    }
+    if (argc > 2 && string(argv[1]) == "ingest-concurrent")
+    {
+        // leaderboard ingest-concurrent file1 [file2 ...]   (one producer thread per file)
+        ensureCSVExists();
+        loadPlayersFromCSVParallel(leaderboard, "players.csv", &boardIndex);
+        loadSubmissions(windows);
+        ingestFilesConcurrently(vector<string>(argv + 2, argv + argc), leaderboard, boardIndex, &windows);
+        persistWriter.shutdown();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "ingest")
+    {
+        // leaderboard ingest [file | -]   (stdin when omitted or "-")
+        ensureCSVExists();
+        loadPlayersFromCSVParallel(leaderboard, "players.csv", &boardIndex);
+        string path = argc > 2 ? argv[2] : "-";
+        if (path == "-")
+        {
+            bulkIngest(cin, leaderboard, boardIndex);
+            persistWriter.shutdown();
+            return 0;
+        }
+        ifstream in(path, ios::binary);
+        if (!in.is_open())
+        {
+            cout << "Could not open " << path << ".\n";
+            return 1;
+        }
+        bulkIngest(in, leaderboard, boardIndex);
+        persistWriter.shutdown();
+        return 0;
+    }
+    if (argc > 2 && string(argv[1]) == "topk")
+    {
+        // leaderboard topk K [file]
+        int k;
+        if (!parseArg("K", argv[2], k))
+        {
+            cout << "Usage: leaderboard topk K [file]\n";
+            return 1;
+        }
+        if (k < 1)
+        {
+            cout << "K must be at least 1.\n";
+            return 1;
+        }
+        loadPlayersFromCSVParallel(leaderboard, argc > 3 ? argv[3] : "players.csv");
+        auto start = chrono::high_resolution_clock::now();
+        vector<int> top = topKHeap(leaderboard, k);
+        auto end = chrono::high_resolution_clock::now();
+        displayRankRange(leaderboard, top, 1);
+        cout << "Top-" << k << " query time: " << fixed << setprecision(3)
+             << chrono::duration<double, milli>(end - start).count() << " ms\n";
+        return 0;
+    }
+
+    // Command-line options:
+    //   --legacy-loader  use the original getline/stringstream CSV loader (for comparison)
+    //   --threads N      thread count for the parallel sorts (default: all cores)
+    //   --key-sort       option 2 sorts (score, index) keys instead of Player records
+    //   --no-snapshot    always parse players.csv, even if players.snap is newer
+    //   --fsync-batch N  background writer fsyncs after N unsynced records (default 64)
+    //   --fsync-ms N     ... or once the oldest unsynced write is N ms old (default 100)
+    //   --page-size N    leaderboard views print the first N ranks (default: all)
+    //   --no-view-history  don't append every view to the history store (option 12 saves)
+    bool legacyLoader = false, useSnapshot = true;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--legacy-loader")
+            legacyLoader = true;
+        else if (arg == "--key-sort")
+            keySortMode = true;
+        else if (arg == "--no-snapshot")
+            useSnapshot = false;
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            if (!parseArg("--threads", argv[++i], sortThreads))
+                return 1;
+        }
+        else if (arg == "--fsync-batch" && i + 1 < argc)
+        {
+            if (!parseArg("--fsync-batch", argv[++i], persistWriter.syncBatch))
+                return 1;
+            persistWriter.syncBatch = max<size_t>(1, persistWriter.syncBatch);
+        }
+        else if (arg == "--fsync-ms" && i + 1 < argc)
+        {
+            if (!parseArg("--fsync-ms", argv[++i], persistWriter.syncIntervalMs))
+                return 1;
+            persistWriter.syncIntervalMs = max(0, persistWriter.syncIntervalMs);
+        }
+        else if (arg == "--page-size" && i + 1 < argc)
+        {
+            if (!parseArg("--page-size", argv[++i], viewPageSize))
+                return 1;
+        }
+        else if (arg == "--no-view-history")
+            viewHistory = false;
+    }
+
+    auto startupStart = chrono::high_resolution_clock::now();
     ensureCSVExists();
-    loadPlayersFromCSV(leaderboard);
+    bool fromSnapshot = useSnapshot && !legacyLoader && playerSnapshotIsFresh() &&
+                        loadPlayerSnapshot(leaderboard, &boardIndex);
+    if (!fromSnapshot && legacyLoader)
+        loadPlayersFromCSV(leaderboard, "players.csv", &boardIndex);
+    else if (!fromSnapshot)
+        loadPlayersFromCSVParallel(leaderboard, "players.csv", &boardIndex);
+    cout << "Startup took " << fixed << setprecision(3)
+         << chrono::duration<double, milli>(chrono::high_resolution_clock::now() - startupStart).count()
+         << " ms (" << (fromSnapshot ? "binary snapshot" : "CSV") << ").\n";
+    loadSubmissions(windows);
 
     while (true)
     {
@@ -528,8 +6358,17 @@ int main()
         cout << "2. Show Leaderboard (choose algorithm)\n";
         cout << "3. Show All Sorting Algorithms (with time)\n";
         cout << "4. Compare All Sorting Algorithms\n";
-        cout << "5. Search Player (Linear / Binary)\n";
+        cout << "5. Search Player (Linear / Binary / Prefix / Fuzzy)\n";
         cout << "6. Exit\n";
+        cout << "7. Rank Queries (live rank index)\n";
+        cout << "8. View Saved Leaderboard Snapshot\n";
+        cout << "9. Top-K Players\n";
+        cout << "10. Bulk Ingest Players (name,score file)\n";
+        cout << "11. Save Binary Snapshot (fast startup)\n";
+        cout << "12. Save Last Sorted Leaderboard to History\n";
+        cout << "13. Daily / Weekly / All-time Leaderboards\n";
+        cout << "14. Concurrent Ingest (one producer thread per file)\n";
+        cout << "15. Multi-Board Engine (named boards per mode/region)\n";
 
         cin >> choice;
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -537,23 +6376,35 @@ int main()
         if (choice == 1)
         {
             Player p;
+            string name;
             cout << "Enter player name: ";
-            getline(cin, p.name);
-            p.name = generateUniqueName(p.name, leaderboard);
+            getline(cin, name);
+            if (name.size() > MAX_NAME_BYTES)
+            {
+                cout << "Name is too long (max " << MAX_NAME_BYTES << " bytes).\n";
+                continue;
+            }
+            p.name = internName(uniqueName(boardIndex, name));
 
             cout << "Enter player score: ";
             cin >> p.score;
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
             leaderboard.push_back(p);
+            indexPlayer(boardIndex, leaderboard, leaderboard.size() - 1);
 
             // Save this player permanently to players.csv
             appendPlayerToCSV(p, "players.csv");
 
             // Also save full leaderboard for viewing/sorting
-            saveToCSV(leaderboard, "Unsorted");
+            saveSnapshot(leaderboard, "Unsorted");
 
-            cout << "Player added as: " << p.name << " and stored permanently.\n";
+            // The new score is also a timestamped submission for the windowed boards
+            recordSubmission(windows, string(nameOf(p)), p.score);
+
+            cout << "Player added as: " << nameOf(p) << " and stored permanently.\n";
+            cout << "Current rank: " << rankOf(boardIndex.rank, leaderboard, leaderboard.size() - 1)
+                 << " of " << leaderboard.size() << "\n";
         }
 
         else if (choice == 2)
@@ -566,56 +6417,61 @@ int main()
 
             cout << "\nChoose sorting algorithm:\n";
             cout << "1. Bubble Sort\n2. Insertion Sort\n3. Selection Sort\n4. Merge Sort\n5. Quick Sort\n6. Heap Sort\n7. Counting Sort\n";
+            cout << "8. Parallel Merge Sort (" << resolveThreadCount(sortThreads) << " threads)\n";
+            cout << "9. Parallel Quick Sort (" << resolveThreadCount(sortThreads) << " threads)\n";
+            cout << "10. Radix Sort\n11. Intro Sort\n12. Tim Sort (run-adaptive merge)\n13. Auto (pick from input statistics)\n";
             int algo;
             cin >> algo;
 
             string algoName; // holds chosen algorithm name
-            vector<Player> temp = leaderboard;
-            auto start = chrono::high_resolution_clock::now();
+            vector<Player> temp;
+            bool valid;
+            double duration, materializeMs = 0;
+            CounterSet counters;
+            HardwareCounters hw;
 
-            switch (algo)
+            if (keySortMode)
+            {
+                vector<SortKey> keys = makeSortKeys(leaderboard);
+                counters = startCounters();
+                auto start = chrono::high_resolution_clock::now();
+                valid = runSortAlgorithm(algo, keys, algoName);
+                auto end = chrono::high_resolution_clock::now();
+                hw = stopCounters(counters);
+                duration = chrono::duration<double, milli>(end - start).count();
+                if (valid)
+                {
+                    temp = materializeOrder(leaderboard, keys);
+                    materializeMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - end).count();
+                }
+            }
+            else
+            {
+                temp = leaderboard;
+                counters = startCounters();
+                auto start = chrono::high_resolution_clock::now();
+                valid = runSortAlgorithm(algo, temp, algoName);
+                auto end = chrono::high_resolution_clock::now();
+                hw = stopCounters(counters);
+                duration = chrono::duration<double, milli>(end - start).count();
+            }
+
+            if (!valid)
             {
-            case 1:
-                algoName = "Bubble Sort";
-                bubbleSort(temp);
-                break;
-            case 2:
-                algoName = "Insertion Sort";
-                insertionSort(temp);
-                break;
-            case 3:
-                algoName = "Selection Sort";
-                selectionSort(temp);
-                break;
-            case 4:
-                algoName = "Merge Sort";
-                mergeSort(temp, 0, temp.size() - 1);
-                break;
-            case 5:
-                algoName = "Quick Sort";
-                quickSort(temp, 0, temp.size() - 1);
-                break;
-            case 6:
-                algoName = "Heap Sort";
-                heapSort(temp);
-                break;
-            case 7:
-                algoName = "Counting Sort";
-                countingSort(temp);
-                break;
-            default:
                 cout << "Invalid choice!\n";
                 continue;
             }
 
-            auto end = chrono::high_resolution_clock::now();
-            double duration = chrono::duration<double, milli>(end - start).count();
-
-            // Display sorted leaderboard and save
+            // Display sorted leaderboard and save (or keep it for option 12)
             displayLeaderboard(temp, algoName, duration);
+            printCounters(hw);
+            if (algo == 13)
+                cout << describeAutoDecision(lastAutoDecision) << "\n";
+            if (keySortMode)
+                cout << "Sorted as key/index pairs; materialising Players took " << materializeMs << " ms\n";
 
-            // Save sorted leaderboard to CSV once more (if desired)
-            //saveToCSV(temp, algoName);
+            lastView = move(temp);
+            lastViewName = algoName;
         }
 
         else if (choice == 4)
@@ -631,45 +6487,20 @@ int main()
                 continue;
             }
 
-            vector<Player> temp;
-            auto start = chrono::high_resolution_clock::now();
-            auto end = start;
-            double duration = 0.0;
-
-            temp = leaderboard;
-            start = chrono::high_resolution_clock::now();
-            bubbleSort(temp);
-            end = chrono::high_resolution_clock::now();
-            duration = chrono::duration<double, milli>(end - start).count();
-            displayLeaderboard(temp, "Bubble Sort", duration);
-
-            temp = leaderboard;
-            start = chrono::high_resolution_clock::now();
-            insertionSort(temp);
-            end = chrono::high_resolution_clock::now();
-            duration = chrono::duration<double, milli>(end - start).count();
-            displayLeaderboard(temp, "Insertion Sort", duration);
-
-            temp = leaderboard;
-            start = chrono::high_resolution_clock::now();
-            selectionSort(temp);
-            end = chrono::high_resolution_clock::now();
-            duration = chrono::duration<double, milli>(end - start).count();
-            displayLeaderboard(temp, "Selection Sort", duration);
-
-            temp = leaderboard;
-            start = chrono::high_resolution_clock::now();
-            mergeSort(temp, 0, temp.size() - 1);
-            end = chrono::high_resolution_clock::now();
-            duration = chrono::duration<double, milli>(end - start).count();
-            displayLeaderboard(temp, "Merge Sort", duration);
-
-            temp = leaderboard;
-            start = chrono::high_resolution_clock::now();
-            quickSort(temp, 0, temp.size() - 1);
-            end = chrono::high_resolution_clock::now();
-            duration = chrono::duration<double, milli>(end - start).count();
-            displayLeaderboard(temp, "Quick Sort", duration);
+            // Bubble, Insertion, Selection, Merge and Quick Sort on fresh copies
+            for (int algo = 1; algo <= 5; algo++)
+            {
+                vector<Player> temp = leaderboard;
+                string algoName;
+                CounterSet counters = startCounters();
+                auto start = chrono::high_resolution_clock::now();
+                runSortAlgorithm(algo, temp, algoName);
+                auto end = chrono::high_resolution_clock::now();
+                HardwareCounters hw = stopCounters(counters);
+                double duration = chrono::duration<double, milli>(end - start).count();
+                displayLeaderboard(temp, algoName, duration);
+                printCounters(hw);
+            }
         }
 
         else if (choice == 5)
@@ -684,11 +6515,52 @@ int main()
             cout << "Enter player name to search: ";
             getline(cin, name);
 
-            cout << "\nChoose search method:\n1. Linear Search\n2. Binary Search (alphabetically sorted)\n";
+            cout << "\nChoose search method:\n1. Linear Search\n2. Binary Search (alphabetically sorted)\n3. Hash Index (exact name)\n"
+                 << "4. Names starting with (autocomplete)\n5. Similar names (edit distance)\n";
             int sChoice;
             cin >> sChoice;
             cin.ignore();
 
+            if (sChoice == 4 || sChoice == 5)
+            {
+                int maxDistance = 0;
+                if (sChoice == 5)
+                {
+                    cout << "Max edit distance (0-" << FUZZY_MAX_DISTANCE << "): ";
+                    cin >> maxDistance;
+                    cin.ignore();
+                    maxDistance = max(0, min(maxDistance, FUZZY_MAX_DISTANCE));
+                    if (name.size() > FUZZY_MAX_QUERY_BYTES)
+                    {
+                        cout << "Query too long (max " << FUZZY_MAX_QUERY_BYTES << " bytes).\n";
+                        continue;
+                    }
+                }
+                auto start = chrono::high_resolution_clock::now();
+                vector<pair<int, int>> matches; // (distance, slot)
+                if (sChoice == 4)
+                    for (int slot : prefixMatches(boardIndex.prefixes, name, SEARCH_SUGGESTIONS))
+                        matches.push_back({0, slot});
+                else
+                    matches = fuzzyMatches(boardIndex.prefixes, name, maxDistance, SEARCH_SUGGESTIONS);
+                double duration = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+
+                if (matches.empty())
+                    cout << "No matching players | Time: " << duration << " ms\n";
+                for (auto &[distance, slot] : matches)
+                {
+                    cout << "  " << nameOf(leaderboard[slot]) << " | Score: " << leaderboard[slot].score;
+                    if (sChoice == 5)
+                        cout << " | Edits: " << distance;
+                    cout << "\n";
+                }
+                if (!matches.empty())
+                    cout << matches.size() << " match(es) | Time: " << duration << " ms\n";
+                cout << "Prefix index: " << boardIndex.prefixes.nodes.size() << " nodes, "
+                     << prefixIndexBytes(boardIndex.prefixes) / 1024.0 << " KB\n";
+                continue;
+            }
+
             int index = -1;
             auto start = chrono::high_resolution_clock::now();
 
@@ -700,9 +6572,13 @@ int main()
             {
                 vector<Player> temp = leaderboard;
                 sort(temp.begin(), temp.end(), [](auto &a, auto &b)
-                     { return a.name < b.name; });
+                     { return nameOf(a) < nameOf(b); });
                 index = binarySearch(temp, name);
             }
+            else if (sChoice == 3)
+            {
+                index = nameLookup(boardIndex.names, name);
+            }
 
             auto end = chrono::high_resolution_clock::now();
             double duration = chrono::duration<double, milli>(end - start).count();
@@ -711,19 +6587,360 @@ int main()
                 cout << "Player found! Name: " << name << " | Time: " << duration << " ms\n";
             else
                 cout << "Player not found | Time: " << duration << " ms\n";
+            if (sChoice == 3)
+                cout << "Index build: " << boardIndex.buildMs << " ms | Index memory: "
+                     << nameIndexBytes(boardIndex.names) / 1024.0 << " KB for " << boardIndex.names.count << " names\n";
         }
 
         else if (choice == 6)
         {
+            // Clean exit refreshes the binary snapshot for the next startup
+            if (useSnapshot)
+                writePlayerSnapshot(leaderboard);
             cout << "Exiting... Goodbye!\n";
             break;
         }
 
+        else if (choice == 7)
+        {
+            if (leaderboard.empty())
+            {
+                cout << "Leaderboard is empty!\n";
+                continue;
+            }
+
+            cout << "\n1. Rank of player\n2. Player at rank\n3. Range of ranks\n4. Page of ranks\n5. Ranks around a player\n";
+            int rChoice;
+            cin >> rChoice;
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+            auto start = chrono::high_resolution_clock::now();
+            if (rChoice == 1)
+            {
+                string name;
+                cout << "Enter player name: ";
+                getline(cin, name);
+                start = chrono::high_resolution_clock::now();
+                int slot = nameLookup(boardIndex.names, name);
+                if (slot == -1)
+                    cout << "Player not found\n";
+                else
+                    cout << name << " is ranked " << rankOf(boardIndex.rank, leaderboard, slot)
+                         << " of " << leaderboard.size() << " with score " << leaderboard[slot].score << "\n";
+            }
+            else if (rChoice == 2)
+            {
+                int rank;
+                cout << "Enter rank: ";
+                cin >> rank;
+                start = chrono::high_resolution_clock::now();
+                int slot = playerAtRank(boardIndex.rank, rank);
+                if (slot == -1)
+                    cout << "No player at rank " << rank << "\n";
+                else
+                    cout << "Rank " << rank << ": " << nameOf(leaderboard[slot]) << " (" << leaderboard[slot].score << ")\n";
+            }
+            else if (rChoice == 3)
+            {
+                int from, to;
+                cout << "Enter first and last rank: ";
+                cin >> from >> to;
+                start = chrono::high_resolution_clock::now();
+                displayRankRange(leaderboard, rankRange(boardIndex.rank, from, to), max(from, 1));
+            }
+            else if (rChoice == 4)
+            {
+                int page, size;
+                cout << "Enter page number and page size: ";
+                cin >> page >> size;
+                start = chrono::high_resolution_clock::now();
+                size = max(size, 1);
+                long long pages = (leaderboard.size() + size - 1) / size;
+                page = int(max(1LL, min<long long>(page, pages)));
+                int from = (page - 1) * size + 1;
+                displayRankRange(leaderboard, rankRange(boardIndex.rank, from, from + size - 1), from);
+                cout << "Page " << page << " of " << pages << "\n";
+            }
+            else if (rChoice == 5)
+            {
+                string name;
+                int radius;
+                cout << "Enter player name: ";
+                getline(cin, name);
+                cout << "Rows above and below: ";
+                cin >> radius;
+                start = chrono::high_resolution_clock::now();
+                int slot = nameLookup(boardIndex.names, name);
+                if (slot == -1)
+                    cout << "Player not found\n";
+                else
+                {
+                    int rank = rankOf(boardIndex.rank, leaderboard, slot);
+                    radius = max(radius, 0);
+                    int from = max(1, rank - radius);
+                    int to = int(min<long long>((long long)rank + radius, leaderboard.size()));
+                    displayRankRange(leaderboard, rankRange(boardIndex.rank, from, to), from);
+                }
+            }
+            else
+            {
+                cout << "Invalid choice!\n";
+                continue;
+            }
+
+            auto end = chrono::high_resolution_clock::now();
+            double duration = chrono::duration<double, milli>(end - start).count();
+            cout << "Query time: " << fixed << setprecision(3) << duration << " ms\n";
+        }
+
+        else if (choice == 8)
+        {
+            persistWriter.flush(); // reads must see queued snapshots
+            HistoryHeader h = readHistoryHeader();
+            if (h.snapshots == 0)
+            {
+                cout << "No snapshots saved yet!\n";
+                continue;
+            }
+
+            int n;
+            cout << h.snapshots << " snapshots (" << h.totalRows << " rows) stored. Enter snapshot number: ";
+            cin >> n;
+
+            TransientNames scratch; // the snapshot's names are dropped once it is shown
+            vector<Player> snapshot;
+            string algoName;
+            uint64_t firstRank;
+            auto start = chrono::high_resolution_clock::now();
+            bool ok = loadSnapshot(n, snapshot, algoName, firstRank);
+            auto end = chrono::high_resolution_clock::now();
+            double duration = chrono::duration<double, milli>(end - start).count();
+            if (!ok)
+            {
+                cout << "Could not read snapshot " << n << "\n";
+                continue;
+            }
+
+            vector<int> slots(snapshot.size());
+            for (int i = 0; i < int(slots.size()); i++)
+                slots[i] = i;
+            cout << "\nSnapshot #" << n << " (" << algoName << "), history rows " << firstRank
+                 << "-" << firstRank + snapshot.size() - 1;
+            displayRankRange(snapshot, slots, 1);
+            cout << "Read time: " << fixed << setprecision(3) << duration << " ms\n";
+        }
+
+        else if (choice == 9)
+        {
+            if (leaderboard.empty())
+            {
+                cout << "Leaderboard is empty!\n";
+                continue;
+            }
+
+            int k;
+            cout << "Enter K: ";
+            cin >> k;
+            if (k < 1)
+            {
+                cout << "K must be at least 1.\n";
+                continue;
+            }
+
+            // Served from the streaming heap when it is large enough, otherwise a bounded heap pass
+            auto start = chrono::high_resolution_clock::now();
+            vector<int> top = k <= STREAMING_TOP_K ? streamingTopK(boardIndex.topHeap, leaderboard, k)
+                                                   : topKHeap(leaderboard, k);
+            auto end = chrono::high_resolution_clock::now();
+            double duration = chrono::duration<double, milli>(end - start).count();
+
+            cout << "\nTop " << top.size() << " players";
+            displayRankRange(leaderboard, top, 1);
+            cout << "Query time: " << fixed << setprecision(3) << duration << " ms ("
+                 << (k <= STREAMING_TOP_K ? "streaming heap" : "bounded heap") << ")\n";
+        }
+
+        else if (choice == 10)
+        {
+            string path;
+            cout << "Enter file to ingest: ";
+            getline(cin, path);
+            ifstream in(path, ios::binary);
+            if (!in.is_open())
+            {
+                cout << "Could not open " << path << ".\n";
+                continue;
+            }
+            bulkIngest(in, leaderboard, boardIndex);
+        }
+
+        else if (choice == 11)
+        {
+            writePlayerSnapshot(leaderboard);
+        }
+
+        else if (choice == 12)
+        {
+            if (lastView.empty())
+                cout << "No sorted leaderboard to save yet (use option 2 first)!\n";
+            else
+                saveSnapshot(lastView, lastViewName);
+        }
+
+        else if (choice == 13)
+        {
+            cout << "\n1. Submit score\n2. Top players of a window\n3. Player's rank in every window\n";
+            int wChoice;
+            cin >> wChoice;
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+            // Queries first retire windows that ended since the last submission
+            int64_t now = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+            auto start = chrono::high_resolution_clock::now();
+            if (wChoice == 1)
+            {
+                string name;
+                int score;
+                cout << "Enter player name: ";
+                getline(cin, name);
+                cout << "Enter score: ";
+                cin >> score;
+                start = chrono::high_resolution_clock::now();
+                recordSubmission(windows, name, score);
+                cout << "Score recorded.\n";
+            }
+            else if (wChoice == 2)
+            {
+                int w, k;
+                cout << "Window (1. Daily, 2. Weekly, 3. All-time) and number of players: ";
+                cin >> w >> k;
+                if (w < 1 || w > 3)
+                {
+                    cout << "Invalid choice!\n";
+                    continue;
+                }
+                start = chrono::high_resolution_clock::now();
+                rollWindows(windows, now);
+                const WindowBoard &board = windows.boards[w - 1];
+                cout << "\n" << board.label << " leaderboard (" << board.entries.size() << " players)";
+                displayRankRange(board.entries, rankRange(board.rank, 1, k), 1);
+            }
+            else if (wChoice == 3)
+            {
+                string name;
+                cout << "Enter player name: ";
+                getline(cin, name);
+                start = chrono::high_resolution_clock::now();
+                rollWindows(windows, now);
+                for (const auto &board : windows.boards)
+                {
+                    int slot = nameLookup(board.names, name);
+                    cout << left << setw(10) << board.label;
+                    if (slot == -1)
+                        cout << "no submissions\n";
+                    else
+                        cout << "rank " << rankOf(board.rank, board.entries, slot) << " of " << board.entries.size()
+                             << ", best score " << board.entries[slot].score << "\n";
+                }
+            }
+            else
+            {
+                cout << "Invalid choice!\n";
+                continue;
+            }
+
+            auto end = chrono::high_resolution_clock::now();
+            double duration = chrono::duration<double, milli>(end - start).count();
+            cout << "Query time: " << fixed << setprecision(3) << duration << " ms\n";
+        }
+
+        else if (choice == 14)
+        {
+            string line, path;
+            vector<string> files;
+            cout << "Enter files to ingest (separated by spaces): ";
+            getline(cin, line);
+            istringstream paths(line);
+            while (paths >> path)
+                files.push_back(path);
+            if (files.empty())
+            {
+                cout << "No files given!\n";
+                continue;
+            }
+            ingestFilesConcurrently(files, leaderboard, boardIndex, &windows);
+        }
+
+        else if (choice == 15)
+        {
+            cout << "\n1. Submit score to a board\n2. Top players of a board\n3. Player's rank on a board\n4. List boards\n";
+            int eChoice;
+            cin >> eChoice;
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+            string board, name;
+            if (eChoice >= 1 && eChoice <= 3)
+            {
+                cout << "Enter board name (e.g. ranked-eu): ";
+                getline(cin, board);
+            }
+            auto start = chrono::high_resolution_clock::now();
+            if (eChoice == 1)
+            {
+                int score;
+                cout << "Enter player name: ";
+                getline(cin, name);
+                cout << "Enter score: ";
+                cin >> score;
+                start = chrono::high_resolution_clock::now();
+                engineSubmit(engine, board, {{name, score}});
+                cout << "Score submitted to '" << board << "'.\n";
+            }
+            else if (eChoice == 2)
+            {
+                size_t n;
+                cout << "Number of players: ";
+                cin >> n;
+                start = chrono::high_resolution_clock::now();
+                auto top = engineTop(engine, board, n);
+                cout << "\n" << board << " leaderboard\n==============================\n";
+                printBoardRows(1, top.size(), [&](size_t i)
+                               { return make_pair(string_view(top[i].first), top[i].second); });
+            }
+            else if (eChoice == 3)
+            {
+                cout << "Enter player name: ";
+                getline(cin, name);
+                start = chrono::high_resolution_clock::now();
+                int score;
+                size_t rank = engineRankOf(engine, board, name, &score);
+                if (rank == 0)
+                    cout << "Player not found on '" << board << "'\n";
+                else
+                    cout << name << " is ranked " << rank << " on '" << board << "' with score " << score << "\n";
+            }
+            else if (eChoice == 4)
+            {
+                for (auto &b : engineBoards(engine))
+                    cout << left << setw(24) << b.first << b.second << " players\n";
+            }
+            else
+            {
+                cout << "Invalid choice!\n";
+                continue;
+            }
+
+            auto end = chrono::high_resolution_clock::now();
+            double duration = chrono::duration<double, milli>(end - start).count();
+            cout << "Query time: " << fixed << setprecision(3) << duration << " ms\n";
+        }
+
         else
         {
             cout << "Invalid option, try again!\n";
         }
     }
 
+    persistWriter.shutdown(); // write and fsync everything still queued
     return 0;
 }